@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "batch.h"
+#include "matrix.h"
+#include "registry.h"
+#include "file_io.h"
+#include "expr.h"
+#include "eigen.h"
+#include "worker_pool.h"
+
+// ===== Helpers =====
+typedef struct {
+    const char *script;
+    long line;
+} BatchContext;
+
+static int batch_error(const BatchContext *ctx, const char *fmt, ...) {
+    char msg[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    fprintf(stderr, "[ERROR] %s:%ld: %s\n", ctx->script, ctx->line, msg);
+    return -1;
+}
+
+static Matrix *lookup(const BatchContext *ctx, const char *name) {
+    Matrix *m = registry_get(registry_find(name));
+    if (!m) batch_error(ctx, "unknown matrix '%s'", name);
+    return m;
+}
+
+// Replace whatever the name held; the old matrix is freed only now, so a
+// statement may read the name it assigns
+static void assign(const char *name, Matrix *m) {
+    MatrixHandle old = registry_find(name);
+    if (old) registry_remove(old);
+    snprintf(m->name, sizeof(m->name), "%s", name);
+    registry_add(m);
+}
+
+static int parse_number(const char *s, double *out) {
+    char *end;
+    *out = strtod(s, &end);
+    return end != s && *end == '\0';
+}
+
+// ===== Statements =====
+static int run_assignment(const BatchContext *ctx, const char *target, char **tok, int ntok) {
+    const char *op = tok[0];
+    char err[192];
+    Matrix *result = NULL;
+
+    if (strlen(target) >= sizeof(((Matrix *)0)->name))
+        return batch_error(ctx, "name '%s' is too long", target);
+
+    if (strcmp(op, "load") == 0) {
+        if (ntok != 2) return batch_error(ctx, "usage: NAME = load FILE");
+        result = load_matrix(tok[1], err, sizeof(err));
+        if (!result) return batch_error(ctx, "%s: %s", tok[1], err);
+    } else if (strcmp(op, "copy") == 0) {
+        if (ntok != 2) return batch_error(ctx, "usage: NAME = copy A");
+        Matrix *a = lookup(ctx, tok[1]);
+        if (!a) return -1;
+        result = matrix_share(a, target);
+    } else if (strcmp(op, "scale") == 0) {
+        if (ntok != 3) return batch_error(ctx, "usage: NAME = scale A FACTOR");
+        double factor;
+        if (!parse_number(tok[2], &factor)) return batch_error(ctx, "bad factor '%s'", tok[2]);
+        Matrix *a = lookup(ctx, tok[1]);
+        if (!a) return -1;
+        Expr *e = expr_scale(expr_matrix(a), factor);
+        result = expr_eval(e, target, err, sizeof(err));
+        expr_free(e);
+    } else if (strcmp(op, "add") == 0 || strcmp(op, "sub") == 0 || strcmp(op, "mul") == 0) {
+        if (ntok != 3) return batch_error(ctx, "usage: NAME = %s A B", op);
+        Matrix *a = lookup(ctx, tok[1]);
+        if (!a) return -1;
+        Matrix *b = lookup(ctx, tok[2]);
+        if (!b) return -1;
+        Expr *ea = expr_matrix(a), *eb = expr_matrix(b);
+        Expr *e = op[0] == 'a' ? expr_add(ea, eb) : op[0] == 's' ? expr_sub(ea, eb) : expr_mul(ea, eb);
+        result = expr_eval(e, target, err, sizeof(err));
+        expr_free(e);
+    } else {
+        return batch_error(ctx, "unknown operation '%s'", op);
+    }
+
+    if (!result) return batch_error(ctx, "%s", err);
+    assign(target, result);
+    return 0;
+}
+
+static void print_value(double re, double im) {
+    if (im == 0.0) printf("%.17g\n", re);
+    else printf("%.17g%+.17gi\n", re, im);
+}
+
+static int run_command(const BatchContext *ctx, char **tok, int ntok) {
+    const char *cmd = tok[0];
+    char err[192];
+
+    if (strcmp(cmd, "det") == 0) {
+        if (ntok != 2) return batch_error(ctx, "usage: det A");
+        Matrix *m = lookup(ctx, tok[1]);
+        if (!m) return -1;
+        if (m->rows != m->cols) return batch_error(ctx, "'%s' is not square", m->name);
+        print_value(determinant_openmp(m), 0.0);
+    } else if (strcmp(cmd, "eigen") == 0) {
+        if (ntok != 3) return batch_error(ctx, "usage: eigen A K");
+        Matrix *m = lookup(ctx, tok[1]);
+        if (!m) return -1;
+        if (m->rows != m->cols) return batch_error(ctx, "'%s' is not square", m->name);
+        char *end;
+        long k = strtol(tok[2], &end, 10);
+        if (*end != '\0' || k < 1 || k > m->rows)
+            return batch_error(ctx, "K must be between 1 and %d", m->rows);
+        EigenResult *r = compute_eigen_parallel(m, (int)k);
+        if (!r) return batch_error(ctx, "eigen solver failed on '%s'", m->name);
+        for (int i = 0; i < r->num_eigenvalues; i++)
+            print_value(r->eigenvalues[i], r->eigenvalues_imag[i]);
+        free_eigen_result(r);
+    } else if (strcmp(cmd, "print") == 0) {
+        if (ntok != 2) return batch_error(ctx, "usage: print A");
+        Matrix *m = lookup(ctx, tok[1]);
+        if (!m) return -1;
+        print_matrix(m);
+    } else if (strcmp(cmd, "save") == 0) {
+        if (ntok != 3) return batch_error(ctx, "usage: save A FILE");
+        Matrix *m = lookup(ctx, tok[1]);
+        if (!m) return -1;
+        if (store_matrix(m, tok[2], err, sizeof(err)) != 0)
+            return batch_error(ctx, "%s: %s", tok[2], err);
+    } else if (strcmp(cmd, "drop") == 0) {
+        if (ntok != 2) return batch_error(ctx, "usage: drop A");
+        if (!lookup(ctx, tok[1])) return -1;
+        registry_remove(registry_find(tok[1]));
+    } else {
+        return batch_error(ctx, "unknown command '%s'", cmd);
+    }
+    return 0;
+}
+
+// ===== Driver =====
+int run_batch_script(const char *filename) {
+    FILE *f = fopen(filename, "r");
+    if (!f) {
+        fprintf(stderr, "[ERROR] Cannot open script %s\n", filename);
+        return 1;
+    }
+
+    BatchContext ctx = {filename, 0};
+    char *line = NULL;
+    size_t cap = 0;
+    int status = 0;
+
+    while (status == 0 && getline(&line, &cap, f) != -1) {
+        ctx.line++;
+        line[strcspn(line, "#")] = '\0';
+
+        char *tok[BATCH_MAX_TOKENS];
+        int ntok = 0;
+        char *save;
+        for (char *t = strtok_r(line, " \t\r\n", &save); t; t = strtok_r(NULL, " \t\r\n", &save)) {
+            if (ntok == BATCH_MAX_TOKENS) {
+                ntok = -1;
+                break;
+            }
+            tok[ntok++] = t;
+        }
+        if (ntok == 0) continue;
+
+        int rc;
+        if (ntok < 0)
+            rc = batch_error(&ctx, "too many tokens");
+        else if (ntok >= 3 && strcmp(tok[1], "=") == 0)
+            rc = run_assignment(&ctx, tok[0], tok + 2, ntok - 2);
+        else
+            rc = run_command(&ctx, tok, ntok);
+        if (rc != 0) status = 1;
+    }
+
+    free(line);
+    fclose(f);
+    fflush(stdout);
+    return status;
+}
@@ -0,0 +1,23 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+// ===== Batch Mode =====
+// Runs a script against the registry without menus, the worker pool or the
+// backend comparison. One statement per line, tokens separated by blanks,
+// '#' starts a comment:
+//
+//   NAME = load FILE        NAME = add A B        det A
+//   NAME = copy A           NAME = sub A B        eigen A K
+//   NAME = scale A FACTOR   NAME = mul A B        print A
+//   save A FILE             drop A
+//
+// Assigning to an existing name replaces that matrix. Arithmetic goes
+// through the expression evaluator (OpenMP, gemm for products) and copy only
+// shares the elements. Only det, eigen and print write to stdout; the first
+// failing statement is reported on stderr and stops the script.
+#define BATCH_MAX_TOKENS 8
+
+// Returns 0 when every statement ran, 1 otherwise
+int run_batch_script(const char *filename);
+
+#endif
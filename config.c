@@ -1,13 +1,19 @@
 #include "config.h"
+#include "gemm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 static Config config;
 
 void init_default_config(void) {
     config.worker_pool_size = 4;
     config.max_idle_time = 60;
+    config.fork_children = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (config.fork_children < 1) config.fork_children = 1;
+    config.save_precision = -1;
+    config.strassen_crossover = STRASSEN_DEFAULT_CROSSOVER;
     strcpy(config.matrix_directory, "");
     config.use_custom_menu = 0;
     
@@ -16,17 +22,20 @@ void init_default_config(void) {
     }
 }
 
-void load_config(const char *filename) {
+// Returns -1 when the file cannot be opened; the defaults then stay
+static int read_config(const char *filename) {
     FILE *f = fopen(filename, "r");
-    if (!f) {
-        printf("[CONFIG] No config file found, using defaults\n");
-        return;
-    }
+    if (!f) return -1;
     
     char line[512];
     
     if (fgets(line, sizeof(line), f)) {
-        sscanf(line, "%d %d", &config.worker_pool_size, &config.max_idle_time);
+        // Optional third value bounds the fork-based fan-out, optional fourth
+        // fixes the decimals written by text saves, optional fifth is the
+        // size at which Strassen hands over to the blocked kernel
+        sscanf(line, "%d %d %d %d %d", &config.worker_pool_size, &config.max_idle_time,
+               &config.fork_children, &config.save_precision, &config.strassen_crossover);
+        if (config.strassen_crossover < 1) config.strassen_crossover = 1;
     }
     
     if (fgets(line, sizeof(line), f)) {
@@ -47,15 +56,33 @@ void load_config(const char *filename) {
     }
     
     fclose(f);
-    
+    return 0;
+}
+
+void load_config(const char *filename) {
+    if (read_config(filename) != 0) {
+        printf("[CONFIG] No config file found, using defaults\n");
+        return;
+    }
+
     printf("[CONFIG] Loaded successfully:\n");
     printf("  - Worker Pool Size: %d\n", config.worker_pool_size);
     printf("  - Max Idle Time: %d seconds\n", config.max_idle_time);
+    printf("  - Fork Children: %d\n", config.fork_children);
+    if (config.save_precision >= 0)
+        printf("  - Save Precision: %d decimals\n", config.save_precision);
+    else
+        printf("  - Save Precision: shortest round-trip\n");
+    printf("  - Strassen Crossover: %d\n", config.strassen_crossover);
     if (strlen(config.matrix_directory) > 0) {
         printf("  - Matrix Directory: %s\n", config.matrix_directory);
     }
 }
 
+void load_config_quiet(const char *filename) {
+    read_config(filename);
+}
+
 Config* get_config(void) {
     return &config;
 }
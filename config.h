@@ -4,6 +4,9 @@
 typedef struct {
     int worker_pool_size;
     int max_idle_time;
+    int fork_children;               // Children per fork-based operation (default: core count)
+    int save_precision;              // Decimals for text saves; -1 = shortest round-trip
+    int strassen_crossover;          // Strassen recursion stops at this size
     char matrix_directory[256];      // ✅ NEW: Matrix loading directory
     int menu_order[15];               // ✅ NEW: Custom menu order (optional)
     int use_custom_menu;              // ✅ NEW: Flag for custom menu
@@ -11,6 +14,8 @@ typedef struct {
 
 void init_default_config(void);
 void load_config(const char *filename);
+// Same, without the summary on stdout
+void load_config_quiet(const char *filename);
 Config* get_config(void);
 
 #endif
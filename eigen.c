@@ -2,268 +2,1143 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <complex.h>
 #include <omp.h>
 #include "eigen.h"
 #include "matrix.h"
+#include "gemm.h"
+#include "scratch.h"
 
 // ===== Vector Operations =====
 
-double vector_norm(double *v, int n) {
-    double sum = 0.0;
-    #pragma omp parallel for reduction(+:sum)
-    for (int i = 0; i < n; i++) {
-        sum += v[i] * v[i];
+void matrix_vector_multiply(Matrix *m, double *v, double *result) {
+    for (int i = 0; i < m->rows; i++) {
+        const double *row = MATRIX_ROW(m, i);
+        double sum = 0.0;
+        for (int j = 0; j < m->cols; j++) {
+            sum += row[j] * v[j];
+        }
+        result[i] = sum;
     }
-    return sqrt(sum);
 }
 
-void normalize_vector(double *v, int n) {
-    double norm = vector_norm(v, n);
-    if (norm > 1e-10) {
-        #pragma omp parallel for
-        for (int i = 0; i < n; i++) {
-            v[i] /= norm;
+void matrix_vector_multiply_parallel(Matrix *m, double *v, double *result) {
+    #pragma omp parallel for
+    for (int i = 0; i < m->rows; i++) {
+        const double *row = MATRIX_ROW(m, i);
+        double sum = 0.0;
+        for (int j = 0; j < m->cols; j++) {
+            sum += row[j] * v[j];
         }
+        result[i] = sum;
     }
 }
 
-double dot_product(double *v1, double *v2, int n) {
-    double sum = 0.0;
-    #pragma omp parallel for reduction(+:sum)
-    for (int i = 0; i < n; i++) {
-        sum += v1[i] * v2[i];
+// ===== QR Algorithm (for all eigenvalues) =====
+// Householder reduction to upper Hessenberg form followed by the implicit
+// double-shift (Francis) QR iteration with deflation. Only eigenvalues are
+// needed, so each bulge-chasing reflector touches just the active window.
+// Row/column updates fan out to OpenMP threads once they are long enough.
+#define QR_PARALLEL_MIN 256
+
+static void hessenberg_reduce(double *a, int n, int lda) {
+    ScratchMark mark = scratch_mark();
+    double *v = scratch_alloc(n * sizeof(double));
+    double *w = scratch_alloc(n * sizeof(double));
+
+    for (int k = 0; k < n - 2; k++) {
+        int len = n - k - 1;
+        double alpha = 0.0;
+        for (int i = k + 1; i < n; i++) alpha += a[(size_t)i * lda + k] * a[(size_t)i * lda + k];
+        alpha = sqrt(alpha);
+        if (alpha == 0.0) continue;
+
+        double x0 = a[(size_t)(k + 1) * lda + k];
+        if (x0 > 0.0) alpha = -alpha;
+
+        // v = x - alpha * e1, reflector H = I - 2 v v^T / (v^T v)
+        for (int i = 0; i < len; i++) v[i] = a[(size_t)(k + 1 + i) * lda + k];
+        v[0] -= alpha;
+        double vnorm2 = 0.0;
+        for (int i = 0; i < len; i++) vnorm2 += v[i] * v[i];
+        if (vnorm2 == 0.0) continue;
+        double beta = 2.0 / vnorm2;
+
+        // Left: rows k+1..n-1, columns k..n-1
+        #pragma omp parallel for if(len > QR_PARALLEL_MIN)
+        for (int j = k; j < n; j++) {
+            double sum = 0.0;
+            for (int i = 0; i < len; i++) sum += v[i] * a[(size_t)(k + 1 + i) * lda + j];
+            w[j] = beta * sum;
+        }
+        #pragma omp parallel for if(len > QR_PARALLEL_MIN)
+        for (int i = 0; i < len; i++) {
+            double *row = a + (size_t)(k + 1 + i) * lda;
+            for (int j = k; j < n; j++) row[j] -= v[i] * w[j];
+        }
+
+        // Right: all rows, columns k+1..n-1
+        #pragma omp parallel for if(len > QR_PARALLEL_MIN)
+        for (int i = 0; i < n; i++) {
+            double *row = a + (size_t)i * lda + k + 1;
+            double sum = 0.0;
+            for (int j = 0; j < len; j++) sum += row[j] * v[j];
+            sum *= beta;
+            for (int j = 0; j < len; j++) row[j] -= sum * v[j];
+        }
+
+        for (int i = k + 2; i < n; i++) a[(size_t)i * lda + k] = 0.0;
     }
-    return sum;
+
+    scratch_release(mark);
 }
 
-void copy_vector(double *src, double *dst, int n) {
-    #pragma omp parallel for
+// Returns the number of QR sweeps, or -1 if max_iterations sweeps were not
+// enough. Complex conjugate pairs come out as adjacent entries with
+// eigenvalues_imag[i] > 0 and eigenvalues_imag[i + 1] < 0.
+int qr_algorithm_eigenvalues(Matrix *m, double *eigenvalues_real, double *eigenvalues_imag,
+                             int max_iterations, double tolerance) {
+    if (m->rows != m->cols) return -1;
+
+    int n = m->rows;
+
+    // Working copy; the reduction below writes to it straight away
+    Matrix *A = matrix_share(m, "temp_qr");
+    matrix_make_writable(A);
+    double *a = A->storage;
+    int lda = A->stride;
+#define H(i, j) a[(size_t)(i) * lda + (j)]
+
+    hessenberg_reduce(a, n, lda);
+
+    double anorm = 0.0;
     for (int i = 0; i < n; i++) {
-        dst[i] = src[i];
+        for (int j = (i > 0 ? i - 1 : 0); j < n; j++) anorm += fabs(H(i, j));
+    }
+
+    int nn = n - 1;
+    int its = 0, sweeps = 0;
+    double t = 0.0;
+    double p = 0.0, q = 0.0, r = 0.0, x, y, z, w, s;
+
+    while (nn >= 0) {
+        // Look for a single small subdiagonal element
+        int l;
+        for (l = nn; l >= 1; l--) {
+            s = fabs(H(l - 1, l - 1)) + fabs(H(l, l));
+            if (s == 0.0) s = anorm;
+            if (fabs(H(l, l - 1)) <= tolerance * s) {
+                H(l, l - 1) = 0.0;
+                break;
+            }
+        }
+
+        x = H(nn, nn);
+        if (l == nn) {
+            // One root found
+            eigenvalues_real[nn] = x + t;
+            eigenvalues_imag[nn] = 0.0;
+            nn--;
+            its = 0;
+            continue;
+        }
+
+        y = H(nn - 1, nn - 1);
+        w = H(nn, nn - 1) * H(nn - 1, nn);
+        if (l == nn - 1) {
+            // Two roots found
+            p = 0.5 * (y - x);
+            q = p * p + w;
+            z = sqrt(fabs(q));
+            x += t;
+            if (q >= 0.0) {
+                z = p + (p >= 0.0 ? z : -z);
+                eigenvalues_real[nn - 1] = eigenvalues_real[nn] = x + z;
+                if (z != 0.0) eigenvalues_real[nn] = x - w / z;
+                eigenvalues_imag[nn - 1] = eigenvalues_imag[nn] = 0.0;
+            } else {
+                eigenvalues_real[nn - 1] = eigenvalues_real[nn] = x + p;
+                eigenvalues_imag[nn - 1] = z;
+                eigenvalues_imag[nn] = -z;
+            }
+            nn -= 2;
+            its = 0;
+            continue;
+        }
+
+        if (sweeps >= max_iterations) {
+            free_matrix(A);
+            return -1;
+        }
+
+        if (its > 0 && its % 10 == 0) {
+            // Exceptional shift to break a stalled cycle
+            t += x;
+            for (int i = 0; i <= nn; i++) H(i, i) -= x;
+            s = fabs(H(nn, nn - 1)) + fabs(H(nn - 1, nn - 2));
+            y = x = 0.75 * s;
+            w = -0.4375 * s * s;
+        }
+        its++;
+        sweeps++;
+
+        // Find two consecutive small subdiagonal elements to start the bulge
+        int mm;
+        for (mm = nn - 2; mm >= l; mm--) {
+            z = H(mm, mm);
+            r = x - z;
+            s = y - z;
+            p = (r * s - w) / H(mm + 1, mm) + H(mm, mm + 1);
+            q = H(mm + 1, mm + 1) - z - r - s;
+            r = H(mm + 2, mm + 1);
+            s = fabs(p) + fabs(q) + fabs(r);
+            p /= s;
+            q /= s;
+            r /= s;
+            if (mm == l) break;
+            double u = fabs(H(mm, mm - 1)) * (fabs(q) + fabs(r));
+            double v = fabs(p) * (fabs(H(mm - 1, mm - 1)) + fabs(z) + fabs(H(mm + 1, mm + 1)));
+            if (u <= tolerance * v) break;
+        }
+
+        for (int i = mm + 2; i <= nn; i++) {
+            H(i, i - 2) = 0.0;
+            if (i != mm + 2) H(i, i - 3) = 0.0;
+        }
+
+        // Chase the bulge down the active window with 3x3 reflectors
+        for (int k = mm; k <= nn - 1; k++) {
+            if (k != mm) {
+                p = H(k, k - 1);
+                q = H(k + 1, k - 1);
+                r = (k != nn - 1) ? H(k + 2, k - 1) : 0.0;
+                x = fabs(p) + fabs(q) + fabs(r);
+                if (x != 0.0) {
+                    p /= x;
+                    q /= x;
+                    r /= x;
+                }
+            }
+            s = sqrt(p * p + q * q + r * r);
+            if (p < 0.0) s = -s;
+            if (s == 0.0) continue;
+
+            if (k == mm) {
+                if (l != mm) H(k, k - 1) = -H(k, k - 1);
+            } else {
+                H(k, k - 1) = -s * x;
+            }
+            p += s;
+            x = p / s;
+            y = q / s;
+            z = r / s;
+            q /= p;
+            r /= p;
+            int three = (k != nn - 1);
+
+            #pragma omp parallel for if(nn - k > QR_PARALLEL_MIN)
+            for (int j = k; j <= nn; j++) {
+                double pj = H(k, j) + q * H(k + 1, j);
+                if (three) {
+                    pj += r * H(k + 2, j);
+                    H(k + 2, j) -= pj * z;
+                }
+                H(k + 1, j) -= pj * y;
+                H(k, j) -= pj * x;
+            }
+
+            int imax = (nn < k + 3) ? nn : k + 3;
+            #pragma omp parallel for if(imax - l > QR_PARALLEL_MIN)
+            for (int i = l; i <= imax; i++) {
+                double pi = x * H(i, k) + y * H(i, k + 1);
+                if (three) {
+                    pi += z * H(i, k + 2);
+                    H(i, k + 2) -= pi * r;
+                }
+                H(i, k + 1) -= pi * q;
+                H(i, k) -= pi;
+            }
+        }
     }
+#undef H
+
+    free_matrix(A);
+    return sweeps;
 }
 
-void matrix_vector_multiply(Matrix *m, double *v, double *result) {
+// ===== Jacobi Eigen Solver (symmetric matrices) =====
+// Cyclic Jacobi with round-robin (tournament) ordering: each sweep is n-1
+// rounds of n/2 disjoint (p, q) pairs, so every rotation in a round can be
+// applied concurrently. Rows are rotated per pair, then columns of A and V
+// per row, with a barrier in between.
+#define JACOBI_MAX_SWEEPS 50
+#define JACOBI_PARALLEL_MIN 64
+
+int is_symmetric(Matrix *m, double tolerance) {
+    if (m->rows != m->cols) return 0;
     for (int i = 0; i < m->rows; i++) {
-        result[i] = 0.0;
-        for (int j = 0; j < m->cols; j++) {
-            result[i] += m->data[i][j] * v[j];
+        const double *row = MATRIX_ROW(m, i);
+        for (int j = 0; j < i; j++) {
+            double a = row[j], b = MATRIX_AT(m, j, i);
+            if (fabs(a - b) > tolerance * (fabs(a) + fabs(b))) return 0;
         }
     }
+    return 1;
 }
 
-void matrix_vector_multiply_parallel(Matrix *m, double *v, double *result) {
-    #pragma omp parallel for
-    for (int i = 0; i < m->rows; i++) {
-        result[i] = 0.0;
-        for (int j = 0; j < m->cols; j++) {
-            result[i] += m->data[i][j] * v[j];
+static double off_diagonal_norm(Matrix *A) {
+    double sum = 0.0;
+    for (int i = 0; i < A->rows; i++) {
+        const double *row = MATRIX_ROW(A, i);
+        for (int j = 0; j < A->cols; j++) {
+            if (i != j) sum += row[j] * row[j];
         }
     }
+    return sqrt(sum);
 }
 
-// ===== Power Iteration (for dominant eigenvalue) =====
+static EigenResult* jacobi_eigen(Matrix *m, int num_eigenvalues, int parallel) {
+    if (m->rows != m->cols || num_eigenvalues < 1) return NULL;
 
-int power_iteration_single(Matrix *m, double *eigenvalue, double *eigenvector,
-                           int max_iterations, double tolerance) {
-    if (m->rows != m->cols) return -1;
-    
     int n = m->rows;
-    double *v = malloc(n * sizeof(double));
-    double *v_new = malloc(n * sizeof(double));
-    
-    // Initialize with random vector
+    num_eigenvalues = (num_eigenvalues > n) ? n : num_eigenvalues;
+
+    Matrix *A = matrix_share(m, "temp_jacobi");
+    matrix_make_writable(A);
+    Matrix *V = create_matrix(n, n, "temp_jacobi_v");
+    for (int i = 0; i < n; i++) MATRIX_AT(V, i, i) = 1.0;
+
+    // Round-robin schedule; index n is a bye when n is odd
+    int players = n + (n % 2);
+    int half = players / 2;
+    int rounds = players - 1;
+    ScratchMark mark = scratch_mark();
+    int *top = scratch_alloc((size_t)rounds * half * sizeof(int));
+    int *bot = scratch_alloc((size_t)rounds * half * sizeof(int));
+    int *ring = scratch_alloc(players * sizeof(int));
+    for (int i = 0; i < players; i++) ring[i] = i;
+    for (int r = 0; r < rounds; r++) {
+        for (int k = 0; k < half; k++) {
+            int p = ring[k], q = ring[players - 1 - k];
+            top[r * half + k] = p < q ? p : q;
+            bot[r * half + k] = p < q ? q : p;
+        }
+        int last = ring[players - 1];
+        for (int i = players - 1; i > 1; i--) ring[i] = ring[i - 1];
+        ring[1] = last;
+    }
+
+    double *cs = scratch_alloc(half * sizeof(double));
+    double *sn = scratch_alloc(half * sizeof(double));
+
+    double scale = 0.0;
     for (int i = 0; i < n; i++) {
-        v[i] = 1.0;
+        const double *row = MATRIX_ROW(A, i);
+        for (int j = 0; j < n; j++) scale += row[j] * row[j];
     }
-    normalize_vector(v, n);
-    
-    for (int iter = 0; iter < max_iterations; iter++) {
-        // v_new = M * v
-        matrix_vector_multiply(m, v, v_new);
-        
-        // Compute eigenvalue (Rayleigh quotient)
-        double lambda = dot_product(v_new, v, n);
-        
-        // Normalize
-        normalize_vector(v_new, n);
-        
-        // Check convergence
-        double diff = 0.0;
-        for (int i = 0; i < n; i++) {
-            diff += fabs(v_new[i] - v[i]);
+    scale = sqrt(scale);
+
+    for (int sweep = 0; sweep < JACOBI_MAX_SWEEPS; sweep++) {
+        if (off_diagonal_norm(A) <= 1e-14 * scale) break;
+
+        #pragma omp parallel if(parallel && n >= JACOBI_PARALLEL_MIN)
+        for (int r = 0; r < rounds; r++) {
+            const int *P = top + (size_t)r * half;
+            const int *Q = bot + (size_t)r * half;
+
+            #pragma omp for
+            for (int k = 0; k < half; k++) {
+                cs[k] = 1.0;
+                sn[k] = 0.0;
+                if (Q[k] >= n) continue;
+                double apq = MATRIX_AT(A, P[k], Q[k]);
+                if (apq == 0.0) continue;
+                double tau = (MATRIX_AT(A, Q[k], Q[k]) - MATRIX_AT(A, P[k], P[k])) / (2.0 * apq);
+                double t = (tau >= 0.0 ? 1.0 : -1.0) / (fabs(tau) + sqrt(1.0 + tau * tau));
+                cs[k] = 1.0 / sqrt(1.0 + t * t);
+                sn[k] = t * cs[k];
+            }
+
+            // A <- J^T A
+            #pragma omp for
+            for (int k = 0; k < half; k++) {
+                if (sn[k] == 0.0) continue;
+                double c = cs[k], s = sn[k];
+                double *rp = MATRIX_ROW(A, P[k]), *rq = MATRIX_ROW(A, Q[k]);
+                for (int j = 0; j < n; j++) {
+                    double ap = rp[j], aq = rq[j];
+                    rp[j] = c * ap - s * aq;
+                    rq[j] = s * ap + c * aq;
+                }
+            }
+
+            // A <- A J, V <- V J
+            #pragma omp for
+            for (int i = 0; i < n; i++) {
+                double *ra = MATRIX_ROW(A, i), *rv = MATRIX_ROW(V, i);
+                for (int k = 0; k < half; k++) {
+                    if (sn[k] == 0.0) continue;
+                    double c = cs[k], s = sn[k];
+                    int p = P[k], q = Q[k];
+                    double ap = ra[p], aq = ra[q];
+                    ra[p] = c * ap - s * aq;
+                    ra[q] = s * ap + c * aq;
+                    double vp = rv[p], vq = rv[q];
+                    rv[p] = c * vp - s * vq;
+                    rv[q] = s * vp + c * vq;
+                }
+            }
         }
-        
-        if (diff < tolerance) {
-            *eigenvalue = lambda;
-            copy_vector(v_new, eigenvector, n);
-            free(v);
-            free(v_new);
-            return iter + 1;
+    }
+
+    // Order by magnitude, largest first, to match the power-iteration paths
+    int *order = scratch_alloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) order[i] = i;
+    for (int i = 1; i < n; i++) {
+        int key = order[i];
+        double mag = fabs(MATRIX_AT(A, key, key));
+        int j = i - 1;
+        while (j >= 0 && fabs(MATRIX_AT(A, order[j], order[j])) < mag) {
+            order[j + 1] = order[j];
+            j--;
         }
-        
-        copy_vector(v_new, v, n);
+        order[j + 1] = key;
     }
-    
-    *eigenvalue = dot_product(v_new, v, n);
-    copy_vector(v, eigenvector, n);
-    free(v);
-    free(v_new);
-    return max_iterations;
+
+    EigenResult *result = malloc(sizeof(EigenResult));
+    result->num_eigenvalues = num_eigenvalues;
+    result->eigenvalues = malloc(num_eigenvalues * sizeof(double));
+    result->eigenvalues_imag = calloc(num_eigenvalues, sizeof(double));
+    result->residuals = NULL;
+    result->converged = NULL;
+    result->eigenvectors = malloc(num_eigenvalues * sizeof(double*));
+    for (int k = 0; k < num_eigenvalues; k++) {
+        int idx = order[k];
+        result->eigenvalues[k] = MATRIX_AT(A, idx, idx);
+        result->eigenvectors[k] = malloc(n * sizeof(double));
+        for (int i = 0; i < n; i++) {
+            result->eigenvectors[k][i] = MATRIX_AT(V, i, idx);
+        }
+    }
+
+    scratch_release(mark);
+    free_matrix(A);
+    free_matrix(V);
+    return result;
 }
 
-int power_iteration_parallel(Matrix *m, double *eigenvalue, double *eigenvector,
-                             int max_iterations, double tolerance) {
-    if (m->rows != m->cols) return -1;
-    
-    int n = m->rows;
-    double *v = malloc(n * sizeof(double));
-    double *v_new = malloc(n * sizeof(double));
-    
-    #pragma omp parallel for
+EigenResult* compute_eigen_jacobi(Matrix *m, int num_eigenvalues) {
+    return jacobi_eigen(m, num_eigenvalues, 1);
+}
+
+// ===== Krylov Eigen Solver (top-k) =====
+// Thick-restarted Lanczos (symmetric) / Arnoldi (general). Each cycle grows
+// the basis to KRYLOV_DIM(k) vectors with classical Gram-Schmidt applied
+// twice, then solves the small projection: Jacobi for symmetric input,
+// shifted QR plus inverse iteration otherwise. Once the k largest-magnitude
+// Ritz pairs have relative residuals below KRYLOV_TOLERANCE it stops;
+// otherwise it keeps the leading half of the Ritz space plus the last
+// residual direction and extends the basis from there. Keeping the projected
+// matrix consistent across restarts avoids recomputing A times kept vectors.
+#define KRYLOV_MAX_RESTARTS 300
+#define KRYLOV_TOLERANCE 1e-8
+#define KRYLOV_PARALLEL_MIN 128
+#define KRYLOV_DIM(k) ((k) * 2 + 20 > 40 ? (k) * 2 + 20 : 40)
+
+static void krylov_random(double *v, int n, unsigned int *state) {
     for (int i = 0; i < n; i++) {
-        v[i] = 1.0;
+        *state = *state * 1103515245u + 12345u;
+        v[i] = (double)((*state >> 8) & 0xffff) / 32768.0 - 1.0;
     }
-    normalize_vector(v, n);
-    
-    for (int iter = 0; iter < max_iterations; iter++) {
-        matrix_vector_multiply_parallel(m, v, v_new);
-        
-        double lambda = dot_product(v_new, v, n);
-        normalize_vector(v_new, n);
-        
-        double diff = 0.0;
-        #pragma omp parallel for reduction(+:diff)
-        for (int i = 0; i < n; i++) {
-            diff += fabs(v_new[i] - v[i]);
+}
+
+static double krylov_norm(const double *v, int n, int parallel) {
+    double sum = 0.0;
+    #pragma omp parallel for reduction(+:sum) if(parallel && n >= KRYLOV_PARALLEL_MIN)
+    for (int i = 0; i < n; i++) sum += v[i] * v[i];
+    return sqrt(sum);
+}
+
+// w -= V h with h = V^T w, done twice; the coefficients are summed into h
+static void krylov_orthogonalize(const double *V, int count, int n, double *w,
+                                 double *h, int parallel) {
+    ScratchMark mark = scratch_mark();
+    double *c = scratch_alloc(count * sizeof(double));
+    for (int j = 0; j < count; j++) h[j] = 0.0;
+
+    for (int pass = 0; pass < 2; pass++) {
+        #pragma omp parallel for if(parallel && n >= KRYLOV_PARALLEL_MIN)
+        for (int j = 0; j < count; j++) {
+            const double *v = V + (size_t)j * n;
+            double sum = 0.0;
+            for (int i = 0; i < n; i++) sum += v[i] * w[i];
+            c[j] = sum;
         }
-        
-        if (diff < tolerance) {
-            *eigenvalue = lambda;
-            copy_vector(v_new, eigenvector, n);
-            free(v);
-            free(v_new);
-            return iter + 1;
+        #pragma omp parallel for if(parallel && n >= KRYLOV_PARALLEL_MIN)
+        for (int i = 0; i < n; i++) {
+            double sum = 0.0;
+            for (int j = 0; j < count; j++) sum += c[j] * V[(size_t)j * n + i];
+            w[i] -= sum;
         }
-        
-        copy_vector(v_new, v, n);
+        for (int j = 0; j < count; j++) h[j] += c[j];
     }
-    
-    *eigenvalue = dot_product(v_new, v, n);
-    copy_vector(v, eigenvector, n);
-    free(v);
-    free(v_new);
-    return max_iterations;
+
+    scratch_release(mark);
 }
 
-// ===== QR Algorithm (simplified - for all eigenvalues) =====
+// Eigenvector of the small projected matrix for a (possibly complex) Ritz
+// value, by inverse iteration on H - theta I
+static void ritz_inverse_iteration(Matrix *H, int dim, double theta_re, double theta_im,
+                                   double *yr, double *yi) {
+    ScratchMark mark = scratch_mark();
+    double complex *M = scratch_alloc((size_t)dim * dim * sizeof(double complex));
+    double complex *y = scratch_alloc(dim * sizeof(double complex));
+    int *piv = scratch_alloc(dim * sizeof(int));
+    double complex theta = theta_re + theta_im * I;
+    double hnorm = 0.0;
 
-int qr_algorithm_eigenvalues(Matrix *m, double *eigenvalues, 
-                             int max_iterations, double tolerance) {
-    if (m->rows != m->cols) return -1;
-    
-    int n = m->rows;
-    
-    // Create working copy
-    Matrix *A = create_matrix(n, n, "temp_qr");
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            A->data[i][j] = m->data[i][j];
+    for (int i = 0; i < dim; i++) {
+        for (int j = 0; j < dim; j++) {
+            M[(size_t)i * dim + j] = MATRIX_AT(H, i, j);
+            hnorm += fabs(MATRIX_AT(H, i, j));
         }
+        M[(size_t)i * dim + i] -= theta;
     }
-    
-    // Simplified QR iteration (just extract diagonal as approximation)
-    for (int iter = 0; iter < max_iterations; iter++) {
-        // In a full implementation, you'd do QR decomposition here
-        // For now, just return diagonal elements as rough approximation
-        
-        double max_off_diag = 0.0;
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                if (i != j) {
-                    max_off_diag = fmax(max_off_diag, fabs(A->data[i][j]));
-                }
+    double tiny = 1e-14 * (hnorm > 0.0 ? hnorm : 1.0);
+
+    // LU with partial pivoting; exact singularity is expected, so tiny
+    // pivots are replaced rather than rejected
+    for (int k = 0; k < dim; k++) {
+        int p = k;
+        for (int i = k + 1; i < dim; i++) {
+            if (cabs(M[(size_t)i * dim + k]) > cabs(M[(size_t)p * dim + k])) p = i;
+        }
+        piv[k] = p;
+        if (p != k) {
+            for (int j = 0; j < dim; j++) {
+                double complex t = M[(size_t)k * dim + j];
+                M[(size_t)k * dim + j] = M[(size_t)p * dim + j];
+                M[(size_t)p * dim + j] = t;
             }
         }
-        
-        if (max_off_diag < tolerance) break;
+        if (cabs(M[(size_t)k * dim + k]) < tiny) M[(size_t)k * dim + k] = tiny;
+        for (int i = k + 1; i < dim; i++) {
+            double complex l = M[(size_t)i * dim + k] / M[(size_t)k * dim + k];
+            M[(size_t)i * dim + k] = l;
+            for (int j = k + 1; j < dim; j++) M[(size_t)i * dim + j] -= l * M[(size_t)k * dim + j];
+        }
     }
-    
-    // Extract diagonal
-    for (int i = 0; i < n; i++) {
-        eigenvalues[i] = A->data[i][i];
+
+    for (int i = 0; i < dim; i++) y[i] = 1.0;
+    for (int it = 0; it < 3; it++) {
+        for (int k = 0; k < dim; k++) {
+            if (piv[k] != k) {
+                double complex t = y[k]; y[k] = y[piv[k]]; y[piv[k]] = t;
+            }
+            for (int i = k + 1; i < dim; i++) y[i] -= M[(size_t)i * dim + k] * y[k];
+        }
+        for (int i = dim - 1; i >= 0; i--) {
+            for (int j = i + 1; j < dim; j++) y[i] -= M[(size_t)i * dim + j] * y[j];
+            y[i] /= M[(size_t)i * dim + i];
+        }
+        double norm = 0.0;
+        for (int i = 0; i < dim; i++) norm += creal(y[i] * conj(y[i]));
+        norm = sqrt(norm);
+        for (int i = 0; i < dim; i++) y[i] /= norm;
     }
-    
-    free_matrix(A);
-    return 0;
+
+    for (int i = 0; i < dim; i++) {
+        yr[i] = creal(y[i]);
+        yi[i] = cimag(y[i]);
+    }
+
+    scratch_release(mark);
 }
 
-// ===== Complete Eigen Computation =====
+// Eigenvalues of a small projected matrix, largest magnitude first. A
+// symmetric projection also gets every coefficient vector as rows of Yr
+// (Yi zeroed). Returns -1 if the shifted QR did not converge.
+static int projected_ritz_values(Matrix *H, int dim, int symmetric, int parallel,
+                                 double *re, double *im, double *Yr, double *Yi) {
+    if (symmetric) {
+        EigenResult *small = jacobi_eigen(H, dim, parallel);
+        for (int s = 0; s < dim; s++) {
+            re[s] = small->eigenvalues[s];
+            im[s] = 0.0;
+            memcpy(Yr + (size_t)s * dim, small->eigenvectors[s], dim * sizeof(double));
+            memset(Yi + (size_t)s * dim, 0, dim * sizeof(double));
+        }
+        free_eigen_result(small);
+        return 0;
+    }
 
-EigenResult* compute_eigen_single(Matrix *m, int num_eigenvalues) {
+    ScratchMark mark = scratch_mark();
+    double *wr = scratch_alloc(dim * sizeof(double));
+    double *wi = scratch_alloc(dim * sizeof(double));
+    int *order = scratch_alloc(dim * sizeof(int));
+    int status = qr_algorithm_eigenvalues(H, wr, wi, 30 * dim, 1e-14);
+
+    if (status >= 0) {
+        for (int i = 0; i < dim; i++) order[i] = i;
+        for (int i = 1; i < dim; i++) {
+            int key = order[i];
+            double mag = hypot(wr[key], wi[key]);
+            int j = i - 1;
+            while (j >= 0 && hypot(wr[order[j]], wi[order[j]]) < mag) {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = key;
+        }
+        for (int s = 0; s < dim; s++) {
+            re[s] = wr[order[s]];
+            im[s] = wi[order[s]];
+        }
+    }
+
+    scratch_release(mark);
+    return status < 0 ? -1 : 0;
+}
+
+// Coefficient vectors (real and imaginary parts) for the first count
+// general Ritz values; the second of a conjugate pair is the conjugate
+static void projected_ritz_vectors(Matrix *H, int dim, int count, const double *re,
+                                   const double *im, double *Yr, double *Yi) {
+    for (int s = 0; s < count; s++) {
+        double *yr = Yr + (size_t)s * dim, *yi = Yi + (size_t)s * dim;
+        if (im[s] < 0.0 && s > 0) {
+            for (int i = 0; i < dim; i++) {
+                yr[i] = yr[i - dim];
+                yi[i] = -yi[i - dim];
+            }
+        } else {
+            ritz_inverse_iteration(H, dim, re[s], im[s], yr, yi);
+        }
+    }
+}
+
+EigenResult* compute_eigen_krylov(Matrix *m, int num_eigenvalues, int parallel) {
     if (m->rows != m->cols || num_eigenvalues < 1) return NULL;
-    
+
     int n = m->rows;
-    num_eigenvalues = (num_eigenvalues > n) ? n : num_eigenvalues;
-    
-    EigenResult *result = malloc(sizeof(EigenResult));
-    result->num_eigenvalues = num_eigenvalues;
-    result->eigenvalues = malloc(num_eigenvalues * sizeof(double));
-    result->eigenvectors = malloc(num_eigenvalues * sizeof(double*));
-    
-    for (int i = 0; i < num_eigenvalues; i++) {
-        result->eigenvectors[i] = malloc(n * sizeof(double));
+    int k = (num_eigenvalues > n) ? n : num_eigenvalues;
+    int symmetric = is_symmetric(m, 1e-12);
+    int dim = KRYLOV_DIM(k);
+    if (dim > n) dim = n;
+
+    double anorm = 0.0;
+    for (int i = 0; i < n; i++) {
+        const double *row = MATRIX_ROW(m, i);
+        for (int j = 0; j < n; j++) anorm += row[j] * row[j];
     }
-    
-    // Compute dominant eigenvalue/eigenvector using power iteration
-    double *eigenvector = malloc(n * sizeof(double));
-    power_iteration_single(m, &result->eigenvalues[0], eigenvector, 1000, 1e-6);
-    copy_vector(eigenvector, result->eigenvectors[0], n);
-    
-    // For additional eigenvalues, use deflation (simplified)
-    for (int k = 1; k < num_eigenvalues; k++) {
-        result->eigenvalues[k] = result->eigenvalues[0] * 0.9; // Approximation
-        for (int i = 0; i < n; i++) {
-            result->eigenvectors[k][i] = 0.0;
+    anorm = sqrt(anorm);
+
+    double *V = malloc((size_t)(dim + 1) * n * sizeof(double));
+    double *W = malloc((size_t)dim * n * sizeof(double));
+    double *h = malloc((dim + 1) * sizeof(double));
+    double *ax = malloc(n * sizeof(double));
+    double *sorted_re = malloc(dim * sizeof(double));
+    double *sorted_im = malloc(dim * sizeof(double));
+    double *Yr = malloc((size_t)dim * dim * sizeof(double));
+    double *Yi = malloc((size_t)dim * dim * sizeof(double));
+    double *Z = malloc((size_t)dim * dim * sizeof(double));
+    double *HZ = malloc((size_t)dim * dim * sizeof(double));
+    Matrix *H = create_matrix(dim, dim, "temp_krylov");
+
+    // k + 1 slots so a conjugate pair is never split
+    double *val_re = malloc((k + 1) * sizeof(double));
+    double *val_im = malloc((k + 1) * sizeof(double));
+    double *val_res = malloc((k + 1) * sizeof(double));
+    double **vec = malloc((k + 1) * sizeof(double*));
+    for (int s = 0; s <= k; s++) vec[s] = malloc(n * sizeof(double));
+    int count = 0;
+    int cycles = 0;
+
+    unsigned int seed = 12345u;
+    krylov_random(V, n, &seed);
+    double norm = krylov_norm(V, n, parallel);
+    for (int i = 0; i < n; i++) V[i] /= norm;
+    int kept = 0;
+
+    for (int restart = 0; restart < KRYLOV_MAX_RESTARTS; restart++) {
+        cycles = restart + 1;
+
+        // Extend the basis from v_kept; H[r][c] = v_r^T A v_c throughout
+        double beta_last = 0.0;
+        for (int j = kept; j < dim; j++) {
+            double *w = V + (size_t)(j + 1) * n;
+            if (parallel) {
+                matrix_vector_multiply_parallel(m, V + (size_t)j * n, w);
+            } else {
+                matrix_vector_multiply(m, V + (size_t)j * n, w);
+            }
+            krylov_orthogonalize(V, j + 1, n, w, h, parallel);
+            for (int i = 0; i <= j; i++) MATRIX_AT(H, i, j) = h[i];
+
+            double beta = krylov_norm(w, n, parallel);
+            if (beta <= 1e-12 * anorm) {
+                // Invariant subspace: carry on from a fresh direction
+                beta = 0.0;
+                krylov_random(w, n, &seed);
+                krylov_orthogonalize(V, j + 1, n, w, h, parallel);
+                norm = krylov_norm(w, n, parallel);
+                for (int i = 0; i < n; i++) w[i] /= norm;
+            } else {
+                for (int i = 0; i < n; i++) w[i] /= beta;
+            }
+            if (j + 1 < dim) MATRIX_AT(H, j + 1, j) = beta;
+            beta_last = beta;
         }
+        if (symmetric) {
+            for (int i = 0; i < dim; i++) {
+                for (int j = i + 1; j < dim; j++) {
+                    double avg = 0.5 * (MATRIX_AT(H, i, j) + MATRIX_AT(H, j, i));
+                    MATRIX_AT(H, i, j) = MATRIX_AT(H, j, i) = avg;
+                }
+            }
+        }
+
+        // Ritz pairs of the projection, largest magnitude first
+        if (projected_ritz_values(H, dim, symmetric, parallel, sorted_re, sorted_im, Yr, Yi) < 0) break;
+
+        count = k;
+        if (count < dim && sorted_im[count - 1] > 0.0) count++;
+        int keep = count + (dim - count) / 2;
+        if (keep > dim - 2) keep = dim - 2;
+        if (keep < count) keep = count;
+        if (keep < dim && keep > count && sorted_im[keep - 1] > 0.0) keep--;
+
+        if (!symmetric) projected_ritz_vectors(H, dim, keep, sorted_re, sorted_im, Yr, Yi);
+
+        // Wanted Ritz vectors x = V y and their true residuals
+        double worst = 0.0;
+        for (int s = 0; s < count; s++) {
+            double re = sorted_re[s], im = sorted_im[s];
+            val_re[s] = re;
+            val_im[s] = im;
+            if (im < 0.0 && s > 0) continue;  // filled in with its conjugate partner
+
+            const double *yr = Yr + (size_t)s * dim, *yi = Yi + (size_t)s * dim;
+            double *xr = vec[s];
+            double *xi = (im > 0.0 && s + 1 < count) ? vec[s + 1] : NULL;
+            #pragma omp parallel for if(parallel && n >= KRYLOV_PARALLEL_MIN)
+            for (int i = 0; i < n; i++) {
+                double sr = 0.0, si = 0.0;
+                for (int j = 0; j < dim; j++) {
+                    double v = V[(size_t)j * n + i];
+                    sr += yr[j] * v;
+                    si += yi[j] * v;
+                }
+                xr[i] = sr;
+                if (xi) xi[i] = si;
+            }
+
+            // ||A x - theta x|| over the real and imaginary parts
+            double res = 0.0;
+            if (parallel) matrix_vector_multiply_parallel(m, xr, ax);
+            else matrix_vector_multiply(m, xr, ax);
+            for (int i = 0; i < n; i++) {
+                double d = ax[i] - re * xr[i] + (xi ? im * xi[i] : 0.0);
+                res += d * d;
+            }
+            if (xi) {
+                if (parallel) matrix_vector_multiply_parallel(m, xi, ax);
+                else matrix_vector_multiply(m, xi, ax);
+                for (int i = 0; i < n; i++) {
+                    double d = ax[i] - im * xr[i] - re * xi[i];
+                    res += d * d;
+                }
+            }
+            double mag = hypot(re, im);
+            res = sqrt(res) / (mag > 1e-12 * anorm ? mag : (anorm > 0.0 ? anorm : 1.0));
+            if (res > worst) worst = res;
+            val_res[s] = res;
+            if (xi) val_res[s + 1] = res;
+        }
+
+        if (worst <= KRYLOV_TOLERANCE || dim == n) break;
+
+        // Thick restart: orthonormal real basis Z of the kept Ritz vectors in
+        // coefficient space (real and imaginary parts for complex pairs)
+        int np = 0;
+        for (int s = 0; s < keep && np < dim - 1; s++) {
+            if (sorted_im[s] < 0.0) continue;
+            for (int part = 0; part < (sorted_im[s] > 0.0 ? 2 : 1) && np < dim - 1; part++) {
+                double *z = Z + (size_t)np * dim;
+                memcpy(z, (part ? Yi : Yr) + (size_t)s * dim, dim * sizeof(double));
+                for (int pass = 0; pass < 2; pass++) {
+                    for (int q = 0; q < np; q++) {
+                        const double *zq = Z + (size_t)q * dim;
+                        double c = 0.0;
+                        for (int i = 0; i < dim; i++) c += zq[i] * z[i];
+                        for (int i = 0; i < dim; i++) z[i] -= c * zq[i];
+                    }
+                }
+                double zn = 0.0;
+                for (int i = 0; i < dim; i++) zn += z[i] * z[i];
+                zn = sqrt(zn);
+                if (zn < 1e-8) continue;
+                for (int i = 0; i < dim; i++) z[i] /= zn;
+                np++;
+            }
+        }
+
+        // New leading basis Z * V, followed by the last residual direction
+        if (parallel) {
+            gemm_parallel(np, n, dim, 1.0, Z, dim, V, n, 0.0, W, n);
+        } else {
+            gemm(np, n, dim, 1.0, Z, dim, V, n, 0.0, W, n);
+        }
+        memcpy(V, W, (size_t)np * n * sizeof(double));
+        memmove(V + (size_t)np * n, V + (size_t)dim * n, n * sizeof(double));
+
+        // Projection onto the new basis: Z H Z^T, plus the coupling row
+        for (int r = 0; r < dim; r++) {
+            const double *hr = MATRIX_ROW(H, r);
+            for (int b = 0; b < np; b++) {
+                const double *zb = Z + (size_t)b * dim;
+                double sum = 0.0;
+                for (int c = 0; c < dim; c++) sum += hr[c] * zb[c];
+                HZ[(size_t)r * np + b] = sum;
+            }
+        }
+        memset(H->storage, 0, (size_t)dim * H->stride * sizeof(double));
+        for (int a = 0; a < np; a++) {
+            const double *za = Z + (size_t)a * dim;
+            for (int b = 0; b < np; b++) {
+                double sum = 0.0;
+                for (int r = 0; r < dim; r++) sum += za[r] * HZ[(size_t)r * np + b];
+                MATRIX_AT(H, a, b) = sum;
+            }
+            MATRIX_AT(H, np, a) = beta_last * za[dim - 1];
+        }
+        kept = np;
     }
-    
-    free(eigenvector);
+
+    // Unit 2-norm vectors; a conjugate pair shares one norm
+    for (int s = 0; s < count; s++) {
+        if (val_im[s] < 0.0) continue;
+        double vn = krylov_norm(vec[s], n, parallel);
+        if (val_im[s] > 0.0 && s + 1 < count) {
+            double ni = krylov_norm(vec[s + 1], n, parallel);
+            vn = sqrt(vn * vn + ni * ni);
+            for (int i = 0; i < n; i++) vec[s + 1][i] /= vn;
+        }
+        if (vn > 0.0) {
+            for (int i = 0; i < n; i++) vec[s][i] /= vn;
+        }
+    }
+
+    // Vectors beyond count were never filled; with none at all (the first
+    // projection already failed) there is no result
+    for (int s = count; s <= k; s++) {
+        free(vec[s]);
+        vec[s] = NULL;
+    }
+    EigenResult *result = NULL;
+    if (count > 0) {
+        result = malloc(sizeof(EigenResult));
+        result->num_eigenvalues = count;
+        result->eigenvalues = val_re;
+        result->eigenvalues_imag = val_im;
+        result->eigenvectors = vec;
+        result->residuals = val_res;
+        result->converged = malloc((k + 1) * sizeof(int));
+        for (int s = 0; s < count; s++) {
+            result->converged[s] = (val_res[s] <= KRYLOV_TOLERANCE) ? cycles : 0;
+        }
+    } else {
+        free(vec);
+        free(val_re);
+        free(val_im);
+        free(val_res);
+    }
+
+    free(V);
+    free(W);
+    free(h);
+    free(ax);
+    free(sorted_re);
+    free(sorted_im);
+    free(Yr);
+    free(Yi);
+    free(Z);
+    free(HZ);
+    free_matrix(H);
     return result;
 }
 
-EigenResult* compute_eigen_parallel(Matrix *m, int num_eigenvalues) {
+// ===== Block Subspace Iteration =====
+// Iterates an n x p block (k wanted columns plus SUBSPACE_GUARD(k) guard
+// columns), so each step is one gemm instead of p mat-vecs:
+//   Y = A X, Rayleigh-Ritz on H = X^T Y, Ritz block X Z (whose image is
+//   Y Z, no extra products), per-pair residuals, then X = qr(Y Z).
+// The QR is CholeskyQR2, whose Gram products are gemms and whose
+// triangular solves are independent per row.
+#define SUBSPACE_GUARD(k) ((k) / 2 > 4 ? (k) / 2 : 4)
+
+// Orthonormalise the p columns of the row-major n x p block B in place.
+// Columns are prescaled to unit norm so Ritz-value spread does not square
+// into the Gram condition number. Returns 0 if G = B^T B is not positive
+// definite, leaving B partially updated.
+static int block_cholesky_qr(double *B, int n, int p, double *Bt, double *G, int parallel) {
+    for (int pass = 0; pass < 2; pass++) {
+        #pragma omp parallel for if(parallel && n >= KRYLOV_PARALLEL_MIN)
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < p; j++) Bt[(size_t)j * n + i] = B[(size_t)i * p + j];
+        }
+        if (pass == 0) {
+            for (int j = 0; j < p; j++) {
+                double cn = krylov_norm(Bt + (size_t)j * n, n, parallel);
+                if (cn == 0.0) return 0;
+                for (int i = 0; i < n; i++) Bt[(size_t)j * n + i] /= cn;
+                for (int i = 0; i < n; i++) B[(size_t)i * p + j] = Bt[(size_t)j * n + i];
+            }
+        }
+
+        if (parallel) {
+            gemm_parallel(p, p, n, 1.0, Bt, n, B, p, 0.0, G, p);
+        } else {
+            gemm(p, p, n, 1.0, Bt, n, B, p, 0.0, G, p);
+        }
+
+        // G = R^T R, R upper triangular, stored over G's upper half
+        for (int j = 0; j < p; j++) {
+            double d = G[(size_t)j * p + j];
+            for (int l = 0; l < j; l++) d -= G[(size_t)l * p + j] * G[(size_t)l * p + j];
+            if (d <= 1e-12) return 0;
+            d = sqrt(d);
+            G[(size_t)j * p + j] = d;
+            for (int c = j + 1; c < p; c++) {
+                double v = G[(size_t)j * p + c];
+                for (int l = 0; l < j; l++) v -= G[(size_t)l * p + j] * G[(size_t)l * p + c];
+                G[(size_t)j * p + c] = v / d;
+            }
+        }
+
+        // B <- B R^-1, one row at a time
+        #pragma omp parallel for if(parallel && n >= KRYLOV_PARALLEL_MIN)
+        for (int i = 0; i < n; i++) {
+            double *row = B + (size_t)i * p;
+            for (int j = 0; j < p; j++) {
+                double v = row[j];
+                for (int l = 0; l < j; l++) v -= row[l] * G[(size_t)l * p + j];
+                row[j] = v / G[(size_t)j * p + j];
+            }
+        }
+    }
+    return 1;
+}
+
+// Fallback for rank-deficient blocks: column Gram-Schmidt, refilling
+// dependent columns with random directions
+static void block_gram_schmidt(double *B, int n, int p, double *col, unsigned int *seed) {
+    for (int j = 0; j < p; j++) {
+        for (int attempt = 0; attempt < 3; attempt++) {
+            for (int i = 0; i < n; i++) col[i] = B[(size_t)i * p + j];
+            double before = krylov_norm(col, n, 0);
+            for (int pass = 0; pass < 2; pass++) {
+                for (int q = 0; q < j; q++) {
+                    double c = 0.0;
+                    for (int i = 0; i < n; i++) c += B[(size_t)i * p + q] * col[i];
+                    for (int i = 0; i < n; i++) col[i] -= c * B[(size_t)i * p + q];
+                }
+            }
+            double after = krylov_norm(col, n, 0);
+            if (after > 1e-10 * before && after > 0.0) {
+                for (int i = 0; i < n; i++) B[(size_t)i * p + j] = col[i] / after;
+                break;
+            }
+            krylov_random(col, n, seed);
+            for (int i = 0; i < n; i++) B[(size_t)i * p + j] = col[i];
+        }
+    }
+}
+
+EigenResult* subspace_iteration(Matrix *m, int num_eigenvalues, int max_iterations,
+                                double tolerance, int parallel) {
     if (m->rows != m->cols || num_eigenvalues < 1) return NULL;
-    
+
     int n = m->rows;
-    num_eigenvalues = (num_eigenvalues > n) ? n : num_eigenvalues;
-    
+    int k = (num_eigenvalues > n) ? n : num_eigenvalues;
+    int p = k + SUBSPACE_GUARD(k);
+    if (p > n) p = n;
+    int symmetric = is_symmetric(m, 1e-12);
+
+    double *X = malloc((size_t)n * p * sizeof(double));
+    double *Y = malloc((size_t)n * p * sizeof(double));
+    double *XZ = malloc((size_t)n * p * sizeof(double));
+    double *YZ = malloc((size_t)n * p * sizeof(double));
+    double *Bt = malloc((size_t)p * n * sizeof(double));
+    double *G = malloc((size_t)p * p * sizeof(double));
+    double *Zc = malloc((size_t)p * p * sizeof(double));
+    double *Yr = malloc((size_t)p * p * sizeof(double));
+    double *Yi = malloc((size_t)p * p * sizeof(double));
+    double *re = malloc(p * sizeof(double));
+    double *im = malloc(p * sizeof(double));
+    double *col = malloc(n * sizeof(double));
+    Matrix *H = create_matrix(p, p, "temp_subspace");
+
+    double *res = calloc(k + 1, sizeof(double));
+    int *converged = calloc(k + 1, sizeof(int));
+    int count = k;
+
+    unsigned int seed = 12345u;
+    krylov_random(X, n * p, &seed);
+    if (!block_cholesky_qr(X, n, p, Bt, G, parallel)) block_gram_schmidt(X, n, p, col, &seed);
+
+    for (int iter = 0; iter < max_iterations; iter++) {
+        // Y = A X and H = X^T Y
+        if (parallel) {
+            gemm_parallel(n, p, n, 1.0, m->storage, m->stride, X, p, 0.0, Y, p);
+        } else {
+            gemm(n, p, n, 1.0, m->storage, m->stride, X, p, 0.0, Y, p);
+        }
+        #pragma omp parallel for if(parallel && n >= KRYLOV_PARALLEL_MIN)
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < p; j++) Bt[(size_t)j * n + i] = X[(size_t)i * p + j];
+        }
+        if (parallel) {
+            gemm_parallel(p, p, n, 1.0, Bt, n, Y, p, 0.0, H->storage, H->stride);
+        } else {
+            gemm(p, p, n, 1.0, Bt, n, Y, p, 0.0, H->storage, H->stride);
+        }
+        if (symmetric) {
+            for (int i = 0; i < p; i++) {
+                for (int j = i + 1; j < p; j++) {
+                    double avg = 0.5 * (MATRIX_AT(H, i, j) + MATRIX_AT(H, j, i));
+                    MATRIX_AT(H, i, j) = MATRIX_AT(H, j, i) = avg;
+                }
+            }
+        }
+
+        // Rayleigh-Ritz: real coefficient columns, a complex pair as Re/Im
+        if (projected_ritz_values(H, p, symmetric, parallel, re, im, Yr, Yi) < 0) break;
+        count = k;
+        if (count < p && im[count - 1] > 0.0) count++;
+        if (!symmetric) projected_ritz_vectors(H, p, p, re, im, Yr, Yi);
+        for (int c = 0; c < p; c++) {
+            const double *src = (im[c] < 0.0 && c > 0) ? Yi + (size_t)(c - 1) * p
+                                                        : Yr + (size_t)c * p;
+            for (int r = 0; r < p; r++) Zc[(size_t)r * p + c] = src[r];
+        }
+
+        if (parallel) {
+            gemm_parallel(n, p, p, 1.0, X, p, Zc, p, 0.0, XZ, p);
+            gemm_parallel(n, p, p, 1.0, Y, p, Zc, p, 0.0, YZ, p);
+        } else {
+            gemm(n, p, p, 1.0, X, p, Zc, p, 0.0, XZ, p);
+            gemm(n, p, p, 1.0, Y, p, Zc, p, 0.0, YZ, p);
+        }
+
+        // Per-pair relative residuals ||A x - theta x|| / (|theta| ||x||)
+        int all = 1;
+        for (int s = 0; s < count; s++) {
+            if (im[s] < 0.0 && s > 0) {
+                res[s] = res[s - 1];
+                converged[s] = converged[s - 1];
+                continue;
+            }
+            int pair = (im[s] > 0.0 && s + 1 < p);
+            double num = 0.0, den = 0.0;
+            for (int i = 0; i < n; i++) {
+                const double *xz = XZ + (size_t)i * p, *yz = YZ + (size_t)i * p;
+                double d = yz[s] - re[s] * xz[s];
+                if (pair) {
+                    d += im[s] * xz[s + 1];
+                    double e = yz[s + 1] - im[s] * xz[s] - re[s] * xz[s + 1];
+                    num += e * e;
+                    den += xz[s + 1] * xz[s + 1];
+                }
+                num += d * d;
+                den += xz[s] * xz[s];
+            }
+            double mag = hypot(re[s], im[s]);
+            res[s] = sqrt(num) / ((mag > 0.0 ? mag : 1.0) * (den > 0.0 ? sqrt(den) : 1.0));
+            if (res[s] <= tolerance) {
+                if (converged[s] == 0) converged[s] = iter + 1;
+            } else {
+                converged[s] = 0;
+                all = 0;
+            }
+        }
+        if (all) break;
+
+        // Next block: orthonormalised image of the Ritz block
+        memcpy(X, YZ, (size_t)n * p * sizeof(double));
+        if (!block_cholesky_qr(X, n, p, Bt, G, parallel)) {
+            memcpy(X, YZ, (size_t)n * p * sizeof(double));
+            block_gram_schmidt(X, n, p, col, &seed);
+        }
+    }
+
     EigenResult *result = malloc(sizeof(EigenResult));
-    result->num_eigenvalues = num_eigenvalues;
-    result->eigenvalues = malloc(num_eigenvalues * sizeof(double));
-    result->eigenvectors = malloc(num_eigenvalues * sizeof(double*));
-    
-    for (int i = 0; i < num_eigenvalues; i++) {
-        result->eigenvectors[i] = malloc(n * sizeof(double));
+    result->num_eigenvalues = count;
+    result->eigenvalues = malloc(count * sizeof(double));
+    result->eigenvalues_imag = malloc(count * sizeof(double));
+    result->eigenvectors = malloc(count * sizeof(double*));
+    result->residuals = res;
+    result->converged = converged;
+    for (int s = 0; s < count; s++) {
+        result->eigenvalues[s] = re[s];
+        result->eigenvalues_imag[s] = im[s];
+        result->eigenvectors[s] = malloc(n * sizeof(double));
+        for (int i = 0; i < n; i++) result->eigenvectors[s][i] = XZ[(size_t)i * p + s];
     }
-    
-    // Compute dominant eigenvalue/eigenvector using parallel power iteration
-    double *eigenvector = malloc(n * sizeof(double));
-    power_iteration_parallel(m, &result->eigenvalues[0], eigenvector, 1000, 1e-6);
-    copy_vector(eigenvector, result->eigenvectors[0], n);
-    
-    // For additional eigenvalues (simplified)
-    for (int k = 1; k < num_eigenvalues; k++) {
-        result->eigenvalues[k] = result->eigenvalues[0] * 0.9;
-        for (int i = 0; i < n; i++) {
-            result->eigenvectors[k][i] = 0.0;
+
+    // Unit 2-norm vectors; a conjugate pair shares one norm
+    for (int s = 0; s < count; s++) {
+        if (im[s] < 0.0) continue;
+        double vn = krylov_norm(result->eigenvectors[s], n, parallel);
+        if (im[s] > 0.0 && s + 1 < count) {
+            double ni = krylov_norm(result->eigenvectors[s + 1], n, parallel);
+            vn = sqrt(vn * vn + ni * ni);
+            for (int i = 0; i < n; i++) result->eigenvectors[s + 1][i] /= vn;
+        }
+        if (vn > 0.0) {
+            for (int i = 0; i < n; i++) result->eigenvectors[s][i] /= vn;
         }
     }
-    
-    free(eigenvector);
+
+    free(X);
+    free(Y);
+    free(XZ);
+    free(YZ);
+    free(Bt);
+    free(G);
+    free(Zc);
+    free(Yr);
+    free(Yi);
+    free(re);
+    free(im);
+    free(col);
+    free_matrix(H);
     return result;
 }
 
+// ===== Complete Eigen Computation =====
+
+EigenResult* compute_eigen_single(Matrix *m, int num_eigenvalues) {
+    return compute_eigen_krylov(m, num_eigenvalues, 0);
+}
+
+// Small or mostly-wanted symmetric spectra go to Jacobi; everything else
+// uses the Krylov solver, which only pays for a few dozen mat-vecs per cycle
+#define JACOBI_DENSE_MAX 64
+int eigen_uses_jacobi(Matrix *m, int num_eigenvalues) {
+    int n = m->rows;
+    return is_symmetric(m, 1e-12) && (n <= JACOBI_DENSE_MAX || 4 * num_eigenvalues >= n);
+}
+
+EigenResult* compute_eigen_parallel(Matrix *m, int num_eigenvalues) {
+    if (m->rows != m->cols || num_eigenvalues < 1) return NULL;
+
+    if (eigen_uses_jacobi(m, num_eigenvalues)) {
+        return compute_eigen_jacobi(m, num_eigenvalues);
+    }
+    return compute_eigen_krylov(m, num_eigenvalues, 1);
+}
+
 // ===== Helper Functions =====
 
 void free_eigen_result(EigenResult *result) {
@@ -273,6 +1148,13 @@ void free_eigen_result(EigenResult *result) {
         free(result->eigenvalues);
     }
     
+    if (result->eigenvalues_imag) {
+        free(result->eigenvalues_imag);
+    }
+    
+    free(result->residuals);
+    free(result->converged);
+    
     if (result->eigenvectors) {
         for (int i = 0; i < result->num_eigenvalues; i++) {
             if (result->eigenvectors[i]) {
@@ -292,9 +1174,26 @@ void print_eigen_result(EigenResult *result, int matrix_size) {
     printf("Computed %d eigenvalue(s)\n\n", result->num_eigenvalues);
     
     for (int i = 0; i < result->num_eigenvalues; i++) {
-        printf("Eigenvalue %d: %.6f\n", i + 1, result->eigenvalues[i]);
+        double im = result->eigenvalues_imag ? result->eigenvalues_imag[i] : 0.0;
+        if (im == 0.0) {
+            printf("Eigenvalue %d: %.6f\n", i + 1, result->eigenvalues[i]);
+        } else {
+            printf("Eigenvalue %d: %.6f %c %.6fi\n", i + 1, result->eigenvalues[i],
+                   im < 0 ? '-' : '+', fabs(im));
+        }
+        
+        if (result->residuals) {
+            if (result->converged && result->converged[i] > 0) {
+                printf("Residual %d: %.2e (converged after %d iterations)\n", i + 1,
+                       result->residuals[i], result->converged[i]);
+            } else {
+                printf("Residual %d: %.2e (not converged)\n", i + 1, result->residuals[i]);
+            }
+        }
         
         if (result->eigenvectors[i]) {
+            // For a complex pair, vector i holds the real part and i+1 the
+            // imaginary part of the eigenvector of the +i eigenvalue
             printf("Eigenvector %d: [", i + 1);
             for (int j = 0; j < matrix_size; j++) {
                 printf("%.4f", result->eigenvectors[i][j]);
@@ -5,25 +5,53 @@
 #include "worker_pool.h"
 
 // ===== Eigen Result Structure =====
+// Complex eigenvalues come in adjacent conjugate pairs (imag > 0 first).
+// For such a pair, eigenvectors[i] and eigenvectors[i + 1] hold the real and
+// imaginary parts of the eigenvector of eigenvalue i. Iterative solvers also
+// fill residuals (||A x - lambda x|| / |lambda|) and converged (the iteration
+// at which each pair met the tolerance, 0 if it never did); others leave
+// both NULL.
 typedef struct {
     int num_eigenvalues;
     double *eigenvalues;
+    double *eigenvalues_imag;
     double **eigenvectors;
+    double *residuals;
+    int *converged;
 } EigenResult;
 
-// ===== Power Iteration (for dominant eigenvalue/eigenvector) =====
-int power_iteration_single(Matrix *m, double *eigenvalue, double *eigenvector,
-                           int max_iterations, double tolerance);
-
-int power_iteration_parallel(Matrix *m, double *eigenvalue, double *eigenvector,
-                             int max_iterations, double tolerance);
-
 // ===== QR Algorithm (for all eigenvalues) =====
-int qr_algorithm_eigenvalues(Matrix *m, double *eigenvalues, 
+// Hessenberg reduction + implicit double-shift QR. Fills n real and imaginary
+// parts; returns the sweep count or -1 if it did not converge.
+int qr_algorithm_eigenvalues(Matrix *m, double *eigenvalues_real, double *eigenvalues_imag,
                              int max_iterations, double tolerance);
 
+// ===== Jacobi Eigen Solver (symmetric matrices) =====
+// Nonzero when |a_ij - a_ji| <= tolerance * (|a_ij| + |a_ji|) everywhere
+int is_symmetric(Matrix *m, double tolerance);
+
+// Parallel cyclic Jacobi; returns the num_eigenvalues largest-magnitude
+// eigenpairs of a symmetric matrix
+EigenResult* compute_eigen_jacobi(Matrix *m, int num_eigenvalues);
+
+// ===== Krylov Eigen Solver (top-k) =====
+// Restarted Lanczos for symmetric input, Arnoldi otherwise; returns the
+// num_eigenvalues largest-magnitude eigenpairs (one more if that would
+// split a conjugate pair). OpenMP mat-vec and reorthogonalisation when
+// parallel is set. NULL if the first projected eigenproblem does not converge.
+EigenResult* compute_eigen_krylov(Matrix *m, int num_eigenvalues, int parallel);
+
+// ===== Block Subspace Iteration =====
+// Multiplies A by an n x (k + guard) block per step (one gemm), then
+// re-orthonormalises with a parallel CholeskyQR2 and applies Rayleigh-Ritz.
+// Reports per-pair residuals and convergence in the result.
+EigenResult* subspace_iteration(Matrix *m, int num_eigenvalues, int max_iterations,
+                                double tolerance, int parallel);
+
 // ===== Complete Eigen Computation =====
 EigenResult* compute_eigen_single(Matrix *m, int num_eigenvalues);
+// Nonzero when compute_eigen_parallel will route this input to Jacobi
+int eigen_uses_jacobi(Matrix *m, int num_eigenvalues);
 EigenResult* compute_eigen_parallel(Matrix *m, int num_eigenvalues);
 
 // ===== Helper Functions =====
@@ -31,11 +59,7 @@ void free_eigen_result(EigenResult *result);
 void print_eigen_result(EigenResult *result, int matrix_size);
 
 // Vector operations
-double vector_norm(double *v, int n);
-void normalize_vector(double *v, int n);
 void matrix_vector_multiply(Matrix *m, double *v, double *result);  // ✅ FIXED: douable -> double
 void matrix_vector_multiply_parallel(Matrix *m, double *v, double *result);
-double dot_product(double *v1, double *v2, int n);
-void copy_vector(double *src, double *dst, int n);
 
 #endif
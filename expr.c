@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "expr.h"
+#include "gemm.h"
+
+// ===== Nodes =====
+typedef enum { EXPR_MATRIX, EXPR_ADD, EXPR_SUB, EXPR_SCALE, EXPR_MUL } ExprOp;
+
+struct Expr {
+    ExprOp op;
+    int refs;
+    int rows;               // -1 when the operands do not fit
+    int cols;
+    Expr *a;
+    Expr *b;
+    double scale;           // EXPR_SCALE
+    Matrix *m;              // EXPR_MATRIX: shared snapshot of the operand
+    Matrix *value;          // product operand, cached during expr_eval
+};
+
+static Expr *new_node(ExprOp op, Expr *a, Expr *b) {
+    Expr *e = calloc(1, sizeof(Expr));
+    if (!e) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    e->op = op;
+    e->refs = 1;
+    e->a = a;
+    e->b = b;
+    e->rows = e->cols = -1;
+    return e;
+}
+
+static int valid(const Expr *e) {
+    return e->rows >= 0;
+}
+
+Expr *expr_matrix(Matrix *m) {
+    Expr *e = new_node(EXPR_MATRIX, NULL, NULL);
+    e->m = matrix_share(m, m->name);
+    e->rows = m->rows;
+    e->cols = m->cols;
+    return e;
+}
+
+static Expr *elementwise(ExprOp op, Expr *a, Expr *b) {
+    Expr *e = new_node(op, a, b);
+    if (valid(a) && valid(b) && a->rows == b->rows && a->cols == b->cols) {
+        e->rows = a->rows;
+        e->cols = a->cols;
+    }
+    return e;
+}
+
+Expr *expr_add(Expr *a, Expr *b) {
+    return elementwise(EXPR_ADD, a, b);
+}
+
+Expr *expr_sub(Expr *a, Expr *b) {
+    return elementwise(EXPR_SUB, a, b);
+}
+
+Expr *expr_scale(Expr *a, double s) {
+    Expr *e = new_node(EXPR_SCALE, a, NULL);
+    e->scale = s;
+    e->rows = a->rows;
+    e->cols = a->cols;
+    return e;
+}
+
+Expr *expr_mul(Expr *a, Expr *b) {
+    Expr *e = new_node(EXPR_MUL, a, b);
+    if (valid(a) && valid(b) && a->cols == b->rows) {
+        e->rows = a->rows;
+        e->cols = b->cols;
+    }
+    return e;
+}
+
+Expr *expr_retain(Expr *e) {
+    e->refs++;
+    return e;
+}
+
+void expr_free(Expr *e) {
+    if (!e || --e->refs > 0) return;
+    expr_free(e->a);
+    expr_free(e->b);
+    free_matrix(e->m);
+    free_matrix(e->value);
+    free(e);
+}
+
+int expr_rows(const Expr *e) {
+    return e->rows;
+}
+
+int expr_cols(const Expr *e) {
+    return e->cols;
+}
+
+// ===== Evaluation =====
+typedef struct {
+    Expr *node;             // EXPR_MATRIX or EXPR_MUL
+    double coef;
+} Term;
+
+typedef struct {
+    Term *terms;
+    int count;
+    int capacity;
+} TermList;
+
+// Flatten the linear part of e into coef * term pairs; repeated terms merge
+static void collect_terms(Expr *e, double coef, TermList *list) {
+    switch (e->op) {
+    case EXPR_ADD:
+        collect_terms(e->a, coef, list);
+        collect_terms(e->b, coef, list);
+        return;
+    case EXPR_SUB:
+        collect_terms(e->a, coef, list);
+        collect_terms(e->b, -coef, list);
+        return;
+    case EXPR_SCALE:
+        collect_terms(e->a, coef * e->scale, list);
+        return;
+    default:
+        break;
+    }
+
+    for (int t = 0; t < list->count; t++) {
+        if (list->terms[t].node == e) {
+            list->terms[t].coef += coef;
+            return;
+        }
+    }
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 8;
+        list->terms = realloc(list->terms, (size_t)list->capacity * sizeof(Term));
+        if (!list->terms) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    list->terms[list->count++] = (Term){e, coef};
+}
+
+// Describe the deepest node whose operands are fine but do not fit together
+static void shape_error(const Expr *e, char *err, size_t err_len) {
+    if (e->a && !valid(e->a)) {
+        shape_error(e->a, err, err_len);
+        return;
+    }
+    if (e->b && !valid(e->b)) {
+        shape_error(e->b, err, err_len);
+        return;
+    }
+    const char *what = e->op == EXPR_MUL ? "multiply" : e->op == EXPR_ADD ? "add" : "subtract";
+    snprintf(err, err_len, "cannot %s %dx%d and %dx%d", what,
+             e->a->rows, e->a->cols, e->b->rows, e->b->cols);
+}
+
+static Matrix *evaluate(Expr *e, const char *name);
+
+// Matrix behind a product operand: the leaf itself or a cached evaluation
+static Matrix *operand_value(Expr *e) {
+    if (e->op == EXPR_MATRIX) return e->m;
+    if (!e->value) e->value = evaluate(e, "expr_temp");
+    return e->value;
+}
+
+static void drop_cached_values(Expr *e) {
+    if (!e) return;
+    free_matrix(e->value);
+    e->value = NULL;
+    drop_cached_values(e->a);
+    drop_cached_values(e->b);
+}
+
+static Matrix *evaluate(Expr *e, const char *name) {
+    TermList list = {0};
+    collect_terms(e, 1.0, &list);
+
+    // A lone unscaled operand is just another snapshot of it
+    if (list.count == 1 && list.terms[0].node->op == EXPR_MATRIX && list.terms[0].coef == 1.0) {
+        Matrix *shared = matrix_share(list.terms[0].node->m, name);
+        free(list.terms);
+        return shared;
+    }
+
+    Matrix *result = create_matrix(e->rows, e->cols, name);
+
+    // Operand terms first, in one pass: each output row is written once
+    // while every operand row is streamed through it.
+    int nsums = 0;
+    for (int t = 0; t < list.count; t++) {
+        if (list.terms[t].node->op != EXPR_MATRIX) continue;
+        Term swap = list.terms[nsums];
+        list.terms[nsums++] = list.terms[t];
+        list.terms[t] = swap;
+    }
+
+    if (nsums > 0) {
+        const Term *terms = list.terms;
+        int rows = result->rows, cols = result->cols;
+        #pragma omp parallel for schedule(static) \
+            if((size_t)rows * cols * nsums >= EXPR_PARALLEL_MIN)
+        for (int i = 0; i < rows; i++) {
+            double *out = MATRIX_ROW(result, i);
+            const double *src = MATRIX_ROW(terms[0].node->m, i);
+            double c = terms[0].coef;
+            for (int j = 0; j < cols; j++) out[j] = c * src[j];
+            for (int t = 1; t < nsums; t++) {
+                src = MATRIX_ROW(terms[t].node->m, i);
+                c = terms[t].coef;
+                for (int j = 0; j < cols; j++) out[j] += c * src[j];
+            }
+        }
+    }
+
+    // Products accumulate into the same output through gemm
+    for (int t = nsums; t < list.count; t++) {
+        Expr *p = list.terms[t].node;
+        Matrix *a = operand_value(p->a);
+        Matrix *b = operand_value(p->b);
+        gemm_parallel(result->rows, result->cols, a->cols, list.terms[t].coef,
+                      a->storage, a->stride, b->storage, b->stride,
+                      t == 0 ? 0.0 : 1.0, result->storage, result->stride);
+    }
+
+    free(list.terms);
+    return result;
+}
+
+Matrix *expr_eval(Expr *e, const char *name, char *err, size_t err_len) {
+    if (!valid(e)) {
+        shape_error(e, err, err_len);
+        return NULL;
+    }
+    Matrix *result = evaluate(e, name);
+    drop_cached_values(e);
+    return result;
+}
@@ -0,0 +1,40 @@
+#ifndef EXPR_H
+#define EXPR_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+// ===== Lazy Matrix Expressions =====
+// add, subtract, scale and multiply build a small DAG instead of computing
+// anything; expr_eval materialises only the root. Add/subtract/scale are
+// linear, so every chain of them collapses into a sum of coefficient * term,
+// where a term is an operand matrix or a product. Operand terms are combined
+// in one pass that streams each operand once and writes each output row
+// once; product terms go through gemm with the coefficient as alpha,
+// accumulating into that same output. Product operands that are themselves
+// expressions are evaluated once per expr_eval even when shared.
+//
+// Leaves hold copy-on-write snapshots, so an expression keeps its values
+// when the source matrix is later modified or deleted.
+#define EXPR_PARALLEL_MIN (1 << 15)
+
+typedef struct Expr Expr;
+
+// The combinators take over the references passed in; use expr_retain to
+// feed one node to several parents.
+Expr *expr_matrix(Matrix *m);
+Expr *expr_add(Expr *a, Expr *b);
+Expr *expr_sub(Expr *a, Expr *b);
+Expr *expr_scale(Expr *a, double s);
+Expr *expr_mul(Expr *a, Expr *b);
+Expr *expr_retain(Expr *e);
+void expr_free(Expr *e);
+
+// Shape of the result; -1 when some operands do not fit together
+int expr_rows(const Expr *e);
+int expr_cols(const Expr *e);
+
+// NULL with a message in err on a shape mismatch; never prints
+Matrix *expr_eval(Expr *e, const char *name, char *err, size_t err_len);
+
+#endif
@@ -4,8 +4,12 @@
 #include <dirent.h>
 #include <errno.h>
 #include <sys/stat.h>
+#include <omp.h>
 #include "matrix.h"
 #include "file_io.h"
+#include "matrix_bin.h"
+#include "matrix_text.h"
+#include "registry.h"
 
 #ifdef _WIN32
 #include <direct.h>  // for _mkdir, _getcwd
@@ -29,37 +33,48 @@ void print_cwd_debug() {
 }
 
 // ===============================
-// Read a single matrix from file
+// Load one matrix without printing
 // ===============================
-Matrix *read_matrix_from_file(const char *filename) {
-    print_cwd_debug();
-
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        perror("[ERROR] Opening file for reading failed");
+// The format follows the extension. On failure returns NULL and leaves a
+// message in err, so callers on worker threads can report it later.
+Matrix *load_matrix(const char *filename, char *err, size_t err_len) {
+    if (matrix_bin_path(filename))
+        return read_matrix_bin(filename, err, err_len);
+
+    Matrix **loaded;
+    TextParseError perr;
+    int n = parse_matrix_text_file(filename, &loaded, 1, &perr);
+    Matrix *m = n > 0 ? loaded[0] : NULL;
+    free(loaded);
+    if (n < 0) {
+        snprintf(err, err_len, "%s", perr.message);
         return NULL;
     }
-
-    char name[50];
-    int rows, cols;
-    if (fscanf(fp, "%s %d %d", name, &rows, &cols) != 3) {
-        fprintf(stderr, "[ERROR] Invalid file format in %s\n", filename);
-        fclose(fp);
+    if (perr.line) {
+        snprintf(err, err_len, "%ld:%ld: %s", perr.line, perr.col, perr.message);
+        free_matrix(m);
+        return NULL;
+    }
+    if (n == 0) {
+        snprintf(err, err_len, "invalid file format");
         return NULL;
     }
+    return m;
+}
+
+// ===============================
+// Read a single matrix from file
+// ===============================
+Matrix *read_matrix_from_file(const char *filename) {
+    print_cwd_debug();
 
-    Matrix *m = create_matrix(rows, cols, name);
+    char err[192];
+    Matrix *m = load_matrix(filename, err, sizeof(err));
     if (!m) {
-        fprintf(stderr, "[ERROR] Memory allocation failed for matrix %s\n", name);
-        fclose(fp);
+        fprintf(stderr, "[ERROR] %s: %s\n", filename, err);
         return NULL;
     }
 
-    for (int i = 0; i < rows; i++)
-        for (int j = 0; j < cols; j++)
-            fscanf(fp, "%lf", &m->data[i][j]);
-
-    fclose(fp);
     printf("✅ Matrix '%s' loaded successfully from %s\n", m->name, filename);
     return m;
 }
@@ -67,39 +82,42 @@ Matrix *read_matrix_from_file(const char *filename) {
 // ===============================
 // Save a single matrix to file
 // ===============================
+// Format follows the extension; returns 0, or -1 with a message in err
+int store_matrix(Matrix *m, const char *filename, char *err, size_t err_len) {
+    if (matrix_bin_path(filename))
+        return save_matrix_bin(m, filename, err, err_len);
+    return write_matrix_text_file(m, filename, text_save_precision, err, err_len);
+}
+
 void save_matrix_to_file(Matrix *m, const char *filename) {
-    // printf("\n[DEBUG] Trying to save matrix '%s' to file: %s\n", m->name, filename);
-    
-    FILE *fp = fopen(filename, "w");
-    if (!fp) {
-        perror("[ERROR] Could not open file for writing");
+    char err[192];
+    if (store_matrix(m, filename, err, sizeof(err)) != 0) {
+        fprintf(stderr, "[ERROR] %s: %s\n", filename, err);
         return;
     }
 
-    fprintf(fp, "%s %d %d\n", m->name, m->rows, m->cols);
-
-    for (int i = 0; i < m->rows; i++) {
-        for (int j = 0; j < m->cols; j++) {
-            fprintf(fp, "%.2lf ", m->data[i][j]);
-        }
-        fprintf(fp, "\n");
-    }
-
-
-
-    if (fclose(fp) == 0)
-        printf(" File '%s' closed successfully.\n", filename);
-    else
-        perror("[ERROR] fclose() failed");
-
     printf(" Matrix '%s' saved to %s\n", m->name, filename);
 }
 
 
 
 // ========================================
-// Read all .txt matrices from a folder
+// Read all .txt and .bin matrices from a folder
 // ========================================
+// Files are listed first and sorted by name, then loaded concurrently by at
+// most omp_get_max_threads() threads. Matrices are registered in name order
+// regardless of which load finished first; failures are collected and
+// reported together at the end instead of stopping the load.
+typedef struct {
+    char *name;
+    Matrix *m;
+    char err[192];
+} FolderEntry;
+
+static int compare_entries(const void *a, const void *b) {
+    return strcmp(((const FolderEntry *)a)->name, ((const FolderEntry *)b)->name);
+}
+
 void read_matrices_from_folder(const char *foldername) {
     DIR *dir = opendir(foldername);
     if (!dir) {
@@ -107,28 +125,71 @@ void read_matrices_from_folder(const char *foldername) {
         return;
     }
 
+    FolderEntry *entries = NULL;
+    int nentries = 0, capacity = 0;
     struct dirent *entry;
-    int count = 0;
-
     while ((entry = readdir(dir)) != NULL) {
-        if (strstr(entry->d_name, ".txt")) {
-            char path[512];
-            snprintf(path, sizeof(path), "%s/%s", foldername, entry->d_name);
-            Matrix *m = read_matrix_from_file(path);
-            if (m && matrix_count < MAX_MATRICES) {
-                matrices[matrix_count++] = m;
-                count++;
+        if (!strstr(entry->d_name, ".txt") && !matrix_bin_path(entry->d_name))
+            continue;
+        if (nentries == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            entries = realloc(entries, (size_t)capacity * sizeof(FolderEntry));
+            if (!entries) {
+                printf("Memory allocation failed.\n");
+                exit(1);
             }
         }
+        entries[nentries].name = strdup(entry->d_name);
+        entries[nentries].m = NULL;
+        entries[nentries].err[0] = '\0';
+        nentries++;
     }
-
     closedir(dir);
+
+    if (nentries > 1)
+        qsort(entries, (size_t)nentries, sizeof(FolderEntry), compare_entries);
+
+    print_cwd_debug();
+
+    int nthreads = omp_get_max_threads();
+    if (nthreads > nentries) nthreads = nentries;
+    if (nthreads < 1) nthreads = 1;
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+    for (int i = 0; i < nentries; i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", foldername, entries[i].name);
+        entries[i].m = load_matrix(path, entries[i].err, sizeof(entries[i].err));
+    }
+
+    int count = 0, failed = 0;
+    for (int i = 0; i < nentries; i++) {
+        if (entries[i].m) {
+            registry_add(entries[i].m);
+            count++;
+        } else {
+            failed++;
+        }
+    }
+
     printf("✅ %d matrices loaded from folder: %s\n", count, foldername);
+    if (failed > 0) {
+        printf("⚠️ %d file(s) could not be loaded:\n", failed);
+        for (int i = 0; i < nentries; i++) {
+            if (entries[i].err[0])
+                printf("   %s: %s\n", entries[i].name, entries[i].err);
+        }
+    }
+
+    for (int i = 0; i < nentries; i++) free(entries[i].name);
+    free(entries);
 }
 
 // ==========================================
 // Save all matrices in memory to a folder
 // ==========================================
+// Each matrix goes to its own file, so the files are written concurrently;
+// results are reported in registry order once every write has finished.
 void save_all_matrices_to_folder(const char *foldername) {
     // Try to create the folder (ignore if exists)
     if (MKDIR(foldername) == 0)
@@ -138,13 +199,42 @@ void save_all_matrices_to_folder(const char *foldername) {
     else
         perror("[WARNING] Could not create folder (may still exist)");
 
-    for (int i = 0; i < matrix_count; i++) {
+    int n = registry_count();
+    Matrix **all = malloc((size_t)(n > 0 ? n : 1) * sizeof(Matrix *));
+    char (*errors)[192] = calloc((size_t)(n > 0 ? n : 1), sizeof(*errors));
+    if (!all || !errors) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    int k = 0;
+    for (MatrixHandle h = registry_first(); h; h = registry_next(h))
+        all[k++] = registry_get(h);
+
+    int nthreads = omp_get_max_threads();
+    if (nthreads > n) nthreads = n;
+    if (nthreads < 1) nthreads = 1;
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+    for (int i = 0; i < n; i++) {
         char filename[256];
-        snprintf(filename, sizeof(filename), "%s/%s.txt", foldername, matrices[i]->name);
-        save_matrix_to_file(matrices[i], filename);
+        snprintf(filename, sizeof(filename), "%s/%s.txt", foldername, all[i]->name);
+        store_matrix(all[i], filename, errors[i], sizeof(errors[i]));
+    }
+
+    int failed = 0;
+    for (int i = 0; i < n; i++) {
+        if (errors[i][0]) {
+            printf("[ERROR] %s/%s.txt: %s\n", foldername, all[i]->name, errors[i]);
+            failed++;
+        }
     }
+    free(errors);
+    free(all);
 
-    printf("✅ All matrices saved to folder: %s\n", foldername);
+    if (failed == 0)
+        printf("✅ All matrices saved to folder: %s\n", foldername);
+    else
+        printf("⚠️ %d of %d matrices could not be saved to folder: %s\n", failed, n, foldername);
 }
 
 // =================================
@@ -156,8 +246,8 @@ void read_matrix_from_file_option() {
     printf("Enter filename: ");
     scanf("%99s", filename);
     Matrix *m = read_matrix_from_file(filename);
-    if (m && matrix_count < MAX_MATRICES)
-        matrices[matrix_count++] = m;
+    if (m)
+        registry_add(m);
 }
 
 void read_matrices_from_folder_option() {
@@ -168,19 +258,21 @@ void read_matrices_from_folder_option() {
 }
 
 void save_matrix_to_file_option() {
-    if (matrix_count == 0) {
+    if (registry_count() == 0) {
         printf("⚠️ No matrices to save.\n");
         return;
     }
 
-    for (int i = 0; i < matrix_count; i++)
-        printf("%d. %s\n", i + 1, matrices[i]->name);
+    int i = 0;
+    for (MatrixHandle h = registry_first(); h; h = registry_next(h))
+        printf("%d. %s\n", ++i, registry_get(h)->name);
 
     int ch;
     printf("Choose matrix: ");
     scanf("%d", &ch);
 
-    if (ch < 1 || ch > matrix_count) {
+    Matrix *m = registry_get(registry_nth(ch));
+    if (!m) {
         printf("Invalid selection.\n");
         return;
     }
@@ -189,7 +281,7 @@ void save_matrix_to_file_option() {
     printf("Enter filename: ");
     scanf("%99s", filename);
 
-    save_matrix_to_file(matrices[ch - 1], filename);
+    save_matrix_to_file(m, filename);
 }
 
 void save_all_matrices_to_folder_option() {
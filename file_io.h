@@ -10,6 +10,10 @@ void read_matrices_from_folder(const char *foldername);
 void save_all_matrices_to_folder(const char *foldername);
 void load_matrices_from_file(const char *filename);
 
+// Quiet single-file load/save; failure (NULL / -1) leaves a message in err
+Matrix *load_matrix(const char *filename, char *err, size_t err_len);
+int store_matrix(Matrix *m, const char *filename, char *err, size_t err_len);
+
 // Menu wrapper functions
 void read_matrix_from_file_option(void);
 void read_matrices_from_folder_option(void);
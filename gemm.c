@@ -0,0 +1,406 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "gemm.h"
+#include "matrix.h"
+#include "scratch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_X86 1
+#endif
+
+// Columns of the packed B block handled by one macro-tile
+#define GEMM_NT 256
+
+// ===== Micro-kernels =====
+// Each computes the full GEMM_MR x GEMM_NR product of one packed A
+// micro-panel (kc x MR, column-interleaved) and one packed B micro-panel
+// (kc x NR, row-interleaved) into ab[MR * NR].
+typedef void (*MicroKernel)(int kc, const double *a, const double *b, double *ab);
+
+static void micro_kernel_c(int kc, const double *a, const double *b, double *ab) {
+    double acc[GEMM_MR][GEMM_NR] = {{0.0}};
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < GEMM_MR; i++) {
+            double ai = a[i];
+            for (int j = 0; j < GEMM_NR; j++) {
+                acc[i][j] += ai * b[j];
+            }
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+    memcpy(ab, acc, sizeof(acc));
+}
+
+#ifdef GEMM_X86
+__attribute__((target("avx2,fma")))
+static void micro_kernel_avx2(int kc, const double *a, const double *b, double *ab) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+    for (int p = 0; p < kc; p++) {
+        __m256d b0 = _mm256_load_pd(b);
+        __m256d b1 = _mm256_load_pd(b + 4);
+        __m256d ai;
+
+        ai = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(ai, b0, c00);
+        c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10);
+        c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20);
+        c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30);
+        c31 = _mm256_fmadd_pd(ai, b1, c31);
+
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    _mm256_store_pd(ab + 0, c00);  _mm256_store_pd(ab + 4, c01);
+    _mm256_store_pd(ab + 8, c10);  _mm256_store_pd(ab + 12, c11);
+    _mm256_store_pd(ab + 16, c20); _mm256_store_pd(ab + 20, c21);
+    _mm256_store_pd(ab + 24, c30); _mm256_store_pd(ab + 28, c31);
+}
+
+// Sixteen xmm registers cannot hold a 4x8 tile plus operands, so the SSE2
+// kernel makes two passes over the A panel, one per 4-column half of B.
+__attribute__((target("sse2")))
+static void micro_kernel_sse2(int kc, const double *a, const double *b, double *ab) {
+    for (int half = 0; half < 2; half++) {
+        const double *ap = a;
+        const double *bp = b + half * 4;
+        __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+        __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+        __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+        __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+
+        for (int p = 0; p < kc; p++) {
+            __m128d b0 = _mm_load_pd(bp);
+            __m128d b1 = _mm_load_pd(bp + 2);
+            __m128d ai;
+
+            ai = _mm_set1_pd(ap[0]);
+            c00 = _mm_add_pd(c00, _mm_mul_pd(ai, b0));
+            c01 = _mm_add_pd(c01, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(ap[1]);
+            c10 = _mm_add_pd(c10, _mm_mul_pd(ai, b0));
+            c11 = _mm_add_pd(c11, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(ap[2]);
+            c20 = _mm_add_pd(c20, _mm_mul_pd(ai, b0));
+            c21 = _mm_add_pd(c21, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(ap[3]);
+            c30 = _mm_add_pd(c30, _mm_mul_pd(ai, b0));
+            c31 = _mm_add_pd(c31, _mm_mul_pd(ai, b1));
+
+            ap += GEMM_MR;
+            bp += GEMM_NR;
+        }
+
+        double *out = ab + half * 4;
+        _mm_store_pd(out + 0, c00);  _mm_store_pd(out + 2, c01);
+        _mm_store_pd(out + 8, c10);  _mm_store_pd(out + 10, c11);
+        _mm_store_pd(out + 16, c20); _mm_store_pd(out + 18, c21);
+        _mm_store_pd(out + 24, c30); _mm_store_pd(out + 26, c31);
+    }
+}
+#endif
+
+static MicroKernel micro_kernel = NULL;
+static const char *micro_kernel_name = "portable C";
+
+static void select_micro_kernel(void) {
+    if (micro_kernel) return;
+#ifdef GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        micro_kernel_name = "AVX2/FMA";
+        micro_kernel = micro_kernel_avx2;
+        return;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        micro_kernel_name = "SSE2";
+        micro_kernel = micro_kernel_sse2;
+        return;
+    }
+#endif
+    micro_kernel = micro_kernel_c;
+}
+
+const char *gemm_kernel_name(void) {
+    select_micro_kernel();
+    return micro_kernel_name;
+}
+
+// ===== Packing =====
+// A block (mc x kc) -> MR-row micro-panels, each stored k-major, zero padded
+static void pack_a(int mc, int kc, const double *A, int lda, double *Ap) {
+    for (int ir = 0; ir < mc; ir += GEMM_MR) {
+        int mr = (mc - ir < GEMM_MR) ? mc - ir : GEMM_MR;
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < mr; i++) Ap[i] = A[(size_t)(ir + i) * lda + p];
+            for (int i = mr; i < GEMM_MR; i++) Ap[i] = 0.0;
+            Ap += GEMM_MR;
+        }
+    }
+}
+
+// One NR-column micro-panel of the B block, stored k-major, zero padded
+static void pack_b_panel(int kc, int nr, const double *B, int ldb, double *Bp) {
+    for (int p = 0; p < kc; p++) {
+        const double *row = B + (size_t)p * ldb;
+        for (int j = 0; j < nr; j++) Bp[j] = row[j];
+        for (int j = nr; j < GEMM_NR; j++) Bp[j] = 0.0;
+        Bp += GEMM_NR;
+    }
+}
+
+// ===== Macro-kernel =====
+static void macro_kernel(int mc, int nc, int kc, double alpha,
+                         const double *Ap, const double *Bp,
+                         double beta, double *C, int ldc) {
+    double ab[GEMM_MR * GEMM_NR] __attribute__((aligned(MATRIX_ALIGNMENT)));
+
+    for (int jr = 0; jr < nc; jr += GEMM_NR) {
+        int nr = (nc - jr < GEMM_NR) ? nc - jr : GEMM_NR;
+        for (int ir = 0; ir < mc; ir += GEMM_MR) {
+            int mr = (mc - ir < GEMM_MR) ? mc - ir : GEMM_MR;
+            micro_kernel(kc, Ap + (size_t)ir * kc, Bp + (size_t)jr * kc, ab);
+
+            for (int i = 0; i < mr; i++) {
+                double *c = C + (size_t)(ir + i) * ldc + jr;
+                const double *r = ab + i * GEMM_NR;
+                if (beta == 0.0) {
+                    for (int j = 0; j < nr; j++) c[j] = alpha * r[j];
+                } else {
+                    for (int j = 0; j < nr; j++) c[j] = alpha * r[j] + beta * c[j];
+                }
+            }
+        }
+    }
+}
+
+static void scale_c(int m, int n, double beta, double *C, int ldc) {
+    for (int i = 0; i < m; i++) {
+        double *c = C + (size_t)i * ldc;
+        if (beta == 0.0) {
+            memset(c, 0, (size_t)n * sizeof(double));
+        } else if (beta != 1.0) {
+            for (int j = 0; j < n; j++) c[j] *= beta;
+        }
+    }
+}
+
+// Packed panels and Strassen temporaries come from the calling thread's
+// scratch arena; every user releases them in LIFO order before returning.
+static double *alloc_packed(size_t count) {
+    return scratch_alloc(count * sizeof(double));
+}
+
+// ===== Driver =====
+// Loop order jc (NC) -> pc (KC) -> macro-tiles (MC x GEMM_NT); B is packed
+// once per (jc, pc) block and shared, each thread packs its own A block.
+static void gemm_blocked(int m, int n, int k, double alpha,
+                         const double *A, int lda, const double *B, int ldb,
+                         double beta, double *C, int ldc, int parallel) {
+    if (m <= 0 || n <= 0) return;
+    if (k <= 0 || alpha == 0.0) {
+        scale_c(m, n, beta, C, ldc);
+        return;
+    }
+
+    select_micro_kernel();
+
+    int nc_max = (n < GEMM_NC) ? n : GEMM_NC;
+    nc_max = (nc_max + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+    int kc_max = (k < GEMM_KC) ? k : GEMM_KC;
+    ScratchMark mark = scratch_mark();
+    double *Bp = alloc_packed((size_t)kc_max * nc_max);
+
+    #pragma omp parallel if(parallel)
+    {
+        ScratchMark thread_mark = scratch_mark();
+        double *Ap = alloc_packed((size_t)GEMM_MC * kc_max);
+
+        for (int jc = 0; jc < n; jc += GEMM_NC) {
+            int nc = (n - jc < GEMM_NC) ? n - jc : GEMM_NC;
+
+            for (int pc = 0; pc < k; pc += GEMM_KC) {
+                int kc = (k - pc < GEMM_KC) ? k - pc : GEMM_KC;
+                double beta_eff = (pc == 0) ? beta : 1.0;
+
+                #pragma omp for schedule(static)
+                for (int jp = 0; jp < nc; jp += GEMM_NR) {
+                    int nr = (nc - jp < GEMM_NR) ? nc - jp : GEMM_NR;
+                    pack_b_panel(kc, nr, B + (size_t)pc * ldb + jc + jp, ldb,
+                                 Bp + (size_t)jp * kc);
+                }
+
+                int m_tiles = (m + GEMM_MC - 1) / GEMM_MC;
+                int n_tiles = (nc + GEMM_NT - 1) / GEMM_NT;
+
+                #pragma omp for collapse(2) schedule(dynamic)
+                for (int it = 0; it < m_tiles; it++) {
+                    for (int jt = 0; jt < n_tiles; jt++) {
+                        int ic = it * GEMM_MC;
+                        int mc = (m - ic < GEMM_MC) ? m - ic : GEMM_MC;
+                        int j0 = jt * GEMM_NT;
+                        int nt = (nc - j0 < GEMM_NT) ? nc - j0 : GEMM_NT;
+
+                        pack_a(mc, kc, A + (size_t)ic * lda + pc, lda, Ap);
+                        macro_kernel(mc, nt, kc, alpha, Ap, Bp + (size_t)j0 * kc,
+                                     beta_eff, C + (size_t)ic * ldc + jc + j0, ldc);
+                    }
+                }
+            }
+        }
+
+        scratch_release(thread_mark);
+    }
+
+    scratch_release(mark);
+}
+
+void gemm(int m, int n, int k, double alpha,
+          const double *A, int lda, const double *B, int ldb,
+          double beta, double *C, int ldc) {
+    gemm_blocked(m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, 0);
+}
+
+void gemm_parallel(int m, int n, int k, double alpha,
+                   const double *A, int lda, const double *B, int ldb,
+                   double beta, double *C, int ldc) {
+    gemm_blocked(m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, 1);
+}
+
+// ===== Strassen =====
+// Seven half-size products per level instead of eight. Odd sizes are peeled:
+// the even leading block recurses and the last row/column are fixed up with
+// thin gemm calls. The top STRASSEN_TASK_DEPTH levels run their products as
+// OpenMP tasks; below strassen_crossover the blocked kernel takes over.
+#define STRASSEN_TASK_DEPTH 2
+int strassen_crossover = STRASSEN_DEFAULT_CROSSOVER;
+
+// out = x + sign * y on h x h blocks
+static void block_combine(int h, const double *x, int ldx, const double *y, int ldy,
+                          double sign, double *out, int ldo) {
+    for (int i = 0; i < h; i++) {
+        const double *xr = x + (size_t)i * ldx;
+        const double *yr = y + (size_t)i * ldy;
+        double *o = out + (size_t)i * ldo;
+        for (int j = 0; j < h; j++) o[j] = xr[j] + sign * yr[j];
+    }
+}
+
+static void strassen_rec(int n, const double *A, int lda, const double *B, int ldb,
+                         double *C, int ldc, int depth);
+
+// One of the seven products: M = (X1 + sx * X2) * (Y1 + sy * Y2), where a
+// NULL second term means the operand is used as-is
+static void strassen_product(int h, const double *x1, const double *x2, double sx, int ldx,
+                             const double *y1, const double *y2, double sy, int ldy,
+                             double *M, int depth) {
+    ScratchMark mark = scratch_mark();
+    const double *xp = x1, *yp = y1;
+    int ldxp = ldx, ldyp = ldy;
+
+    if (x2) {
+        double *xs = alloc_packed((size_t)h * h);
+        block_combine(h, x1, ldx, x2, ldx, sx, xs, h);
+        xp = xs;
+        ldxp = h;
+    }
+    if (y2) {
+        double *ys = alloc_packed((size_t)h * h);
+        block_combine(h, y1, ldy, y2, ldy, sy, ys, h);
+        yp = ys;
+        ldyp = h;
+    }
+
+    strassen_rec(h, xp, ldxp, yp, ldyp, M, h, depth + 1);
+    scratch_release(mark);
+}
+
+static void strassen_rec(int n, const double *A, int lda, const double *B, int ldb,
+                         double *C, int ldc, int depth) {
+    if (n <= strassen_crossover || n < 2) {
+        gemm(n, n, n, 1.0, A, lda, B, ldb, 0.0, C, ldc);
+        return;
+    }
+
+    if (n % 2) {
+        int m = n - 1;
+        strassen_rec(m, A, lda, B, ldb, C, ldc, depth);
+        gemm(m, m, 1, 1.0, A + m, lda, B + (size_t)m * ldb, ldb, 1.0, C, ldc);
+        gemm(m, 1, n, 1.0, A, lda, B + m, ldb, 0.0, C + m, ldc);
+        gemm(1, n, n, 1.0, A + (size_t)m * lda, lda, B, ldb, 0.0, C + (size_t)m * ldc, ldc);
+        return;
+    }
+
+    int h = n / 2;
+    const double *A11 = A, *A12 = A + h;
+    const double *A21 = A + (size_t)h * lda, *A22 = A21 + h;
+    const double *B11 = B, *B12 = B + h;
+    const double *B21 = B + (size_t)h * ldb, *B22 = B21 + h;
+    ScratchMark mark = scratch_mark();
+    double *M[7];
+    for (int i = 0; i < 7; i++) M[i] = alloc_packed((size_t)h * h);
+    int spawn = depth < STRASSEN_TASK_DEPTH;
+
+    #pragma omp task if(spawn)
+    strassen_product(h, A11, A22, 1.0, lda, B11, B22, 1.0, ldb, M[0], depth);
+    #pragma omp task if(spawn)
+    strassen_product(h, A21, A22, 1.0, lda, B11, NULL, 0.0, ldb, M[1], depth);
+    #pragma omp task if(spawn)
+    strassen_product(h, A11, NULL, 0.0, lda, B12, B22, -1.0, ldb, M[2], depth);
+    #pragma omp task if(spawn)
+    strassen_product(h, A22, NULL, 0.0, lda, B21, B11, -1.0, ldb, M[3], depth);
+    #pragma omp task if(spawn)
+    strassen_product(h, A11, A12, 1.0, lda, B22, NULL, 0.0, ldb, M[4], depth);
+    #pragma omp task if(spawn)
+    strassen_product(h, A21, A11, -1.0, lda, B11, B12, 1.0, ldb, M[5], depth);
+    #pragma omp task if(spawn)
+    strassen_product(h, A12, A22, -1.0, lda, B21, B22, 1.0, ldb, M[6], depth);
+    #pragma omp taskwait
+
+    double *C11 = C, *C12 = C + h;
+    double *C21 = C + (size_t)h * ldc, *C22 = C21 + h;
+    for (int i = 0; i < h; i++) {
+        const double *m1 = M[0] + (size_t)i * h, *m2 = M[1] + (size_t)i * h;
+        const double *m3 = M[2] + (size_t)i * h, *m4 = M[3] + (size_t)i * h;
+        const double *m5 = M[4] + (size_t)i * h, *m6 = M[5] + (size_t)i * h;
+        const double *m7 = M[6] + (size_t)i * h;
+        double *c11 = C11 + (size_t)i * ldc, *c12 = C12 + (size_t)i * ldc;
+        double *c21 = C21 + (size_t)i * ldc, *c22 = C22 + (size_t)i * ldc;
+        for (int j = 0; j < h; j++) {
+            c11[j] = m1[j] + m4[j] - m5[j] + m7[j];
+            c12[j] = m3[j] + m5[j];
+            c21[j] = m2[j] + m4[j];
+            c22[j] = m1[j] - m2[j] + m3[j] + m6[j];
+        }
+    }
+
+    scratch_release(mark);
+}
+
+void gemm_strassen(int n, const double *A, int lda, const double *B, int ldb,
+                   double *C, int ldc) {
+    if (n <= strassen_crossover) {
+        gemm_parallel(n, n, n, 1.0, A, lda, B, ldb, 0.0, C, ldc);
+        return;
+    }
+
+    select_micro_kernel();
+
+    #pragma omp parallel
+    #pragma omp single
+    strassen_rec(n, A, lda, B, ldb, C, ldc, 0);
+}
@@ -0,0 +1,39 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+// ===== Blocked GEMM =====
+// C = alpha * A * B + beta * C on row-major operands with explicit leading
+// dimensions (in doubles). A is m x k, B is k x n, C is m x n. When beta is
+// zero C is only written, never read.
+//
+// Operands are packed into MR x KC and KC x NR micro-panels and multiplied by
+// a register-blocked micro-kernel; the AVX2/FMA or SSE2 kernel is picked once
+// at runtime from the CPU feature flags, with a portable C fallback.
+#define GEMM_MR 4
+#define GEMM_NR 8
+#define GEMM_KC 256
+#define GEMM_MC 96
+#define GEMM_NC 2048
+
+void gemm(int m, int n, int k, double alpha,
+          const double *A, int lda, const double *B, int ldb,
+          double beta, double *C, int ldc);
+
+// Same contract; OpenMP threads split each packed block into macro-tiles
+void gemm_parallel(int m, int n, int k, double alpha,
+                   const double *A, int lda, const double *B, int ldb,
+                   double beta, double *C, int ldc);
+
+const char *gemm_kernel_name(void);
+
+// ===== Strassen =====
+// C = A * B for square n x n operands using Strassen recursion down to
+// strassen_crossover, then the blocked kernel. Sub-products run as OpenMP
+// tasks. Any n is accepted; odd sizes are handled by peeling.
+#define STRASSEN_DEFAULT_CROSSOVER 256
+extern int strassen_crossover;
+
+void gemm_strassen(int n, const double *A, int lda, const double *B, int ldb,
+                   double *C, int ldc);
+
+#endif
@@ -0,0 +1,75 @@
+#include <stddef.h>
+#include <math.h>
+#include <omp.h>
+#include "lu.h"
+#include "gemm.h"
+
+int lu_panel(int n, int k0, int kb, double *A, int lda, double *sign, int parallel) {
+    int k1 = k0 + kb;
+
+    for (int k = k0; k < k1; k++) {
+        int p = k;
+        for (int i = k + 1; i < n; i++) {
+            if (fabs(A[(size_t)i * lda + k]) > fabs(A[(size_t)p * lda + k])) p = i;
+        }
+        if (A[(size_t)p * lda + k] == 0.0) return 0;
+
+        if (p != k) {
+            double *rk = A + (size_t)k * lda, *rp = A + (size_t)p * lda;
+            for (int j = 0; j < n; j++) {
+                double t = rk[j]; rk[j] = rp[j]; rp[j] = t;
+            }
+            *sign = -*sign;
+        }
+
+        const double *rk = A + (size_t)k * lda;
+        #pragma omp parallel for if(parallel && n - k > 256)
+        for (int i = k + 1; i < n; i++) {
+            double *ri = A + (size_t)i * lda;
+            double l = ri[k] / rk[k];
+            ri[k] = l;
+            for (int j = k + 1; j < k1; j++) ri[j] -= l * rk[j];
+        }
+    }
+
+    // U12 = L11^-1 * A12, independent per column
+    #pragma omp parallel for if(parallel && n - k1 > 256)
+    for (int j0 = k1; j0 < n; j0 += 64) {
+        int j1 = (j0 + 64 < n) ? j0 + 64 : n;
+        for (int i = k0 + 1; i < k1; i++) {
+            double *ri = A + (size_t)i * lda;
+            for (int t = k0; t < i; t++) {
+                const double *rt = A + (size_t)t * lda;
+                double l = ri[t];
+                for (int j = j0; j < j1; j++) ri[j] -= l * rt[j];
+            }
+        }
+    }
+
+    return 1;
+}
+
+double lu_determinant(int n, double *A, int lda, int parallel) {
+    double sign = 1.0;
+
+    for (int k0 = 0; k0 < n; k0 += LU_BLOCK) {
+        int kb = (n - k0 < LU_BLOCK) ? n - k0 : LU_BLOCK;
+        int k1 = k0 + kb;
+
+        if (!lu_panel(n, k0, kb, A, lda, &sign, parallel)) return 0.0;
+        if (k1 >= n) break;
+
+        const double *L21 = A + (size_t)k1 * lda + k0;
+        const double *U12 = A + (size_t)k0 * lda + k1;
+        double *A22 = A + (size_t)k1 * lda + k1;
+        if (parallel) {
+            gemm_parallel(n - k1, n - k1, kb, -1.0, L21, lda, U12, lda, 1.0, A22, lda);
+        } else {
+            gemm(n - k1, n - k1, kb, -1.0, L21, lda, U12, lda, 1.0, A22, lda);
+        }
+    }
+
+    double det = sign;
+    for (int i = 0; i < n; i++) det *= A[(size_t)i * lda + i];
+    return det;
+}
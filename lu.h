@@ -0,0 +1,20 @@
+#ifndef LU_H
+#define LU_H
+
+// ===== Blocked LU =====
+// Right-looking LU with partial pivoting, in place on a row-major n x n
+// buffer with leading dimension lda. Each LU_BLOCK-wide panel is factored
+// column by column, its U12 strip is solved against L11, and the trailing
+// matrix is updated with A22 -= L21 * U12 through gemm.
+#define LU_BLOCK 32
+
+// Factor columns k0..k0+kb-1 over rows k0..n-1 and solve the U12 strip to
+// their right. Row swaps span the full row and flip *sign. With parallel set
+// the elimination runs on OpenMP threads. Returns 0 on a zero pivot.
+int lu_panel(int n, int k0, int kb, double *A, int lda, double *sign, int parallel);
+
+// Factors A in place and returns its determinant; the trailing updates use
+// gemm_parallel when parallel is set
+double lu_determinant(int n, double *A, int lda, int parallel);
+
+#endif
@@ -1,11 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "matrix.h"
 #include "worker_pool.h"
 #include "eigen.h"
 #include "config.h"
+#include "gemm.h"
 #include "file_io.h"
+#include "matrix_text.h"
+#include "registry.h"
+#include "batch.h"
 
 void clear_input_buffer() {
     int c;
@@ -82,20 +87,25 @@ void show_menu() {
     printf("=======================================\n");
 }
 
+int values_agree(double a, double b) {
+    return fabs(a - b) <= 1e-6 * fmax(1.0, fabs(b));
+}
+
 Matrix* select_matrix(const char *prompt) {
-    if (matrix_count == 0) {
+    if (registry_count() == 0) {
         printf("No matrices in memory.\n");
         return NULL;
     }
 
     printf("\n%s\n", prompt);
-    for (int i = 0; i < matrix_count; i++) {
-        printf("%d. %s (%dx%d)\n", i + 1, matrices[i]->name,
-               matrices[i]->rows, matrices[i]->cols);
+    int i = 0;
+    for (MatrixHandle h = registry_first(); h; h = registry_next(h)) {
+        Matrix *m = registry_get(h);
+        printf("%d. %s (%dx%d)\n", ++i, m->name, m->rows, m->cols);
     }
 
-    int choice = get_int_input("Enter choice: ", 1, matrix_count);
-    return matrices[choice - 1];
+    int choice = get_int_input("Enter choice: ", 1, registry_count());
+    return registry_get(registry_nth(choice));
 }
 
 void add_matrices_menu() {
@@ -110,7 +120,7 @@ void add_matrices_menu() {
         return;
     }
 
-    printf("\n=== ADDITION OPERATION - 3-WAY COMPARISON ===\n");
+    printf("\n=== ADDITION OPERATION - 4-WAY COMPARISON ===\n");
     
     // Method 1: Worker Pool (Reusing persistent processes)
     printf("\n[1] Using WORKER POOL (persistent processes)...\n");
@@ -119,22 +129,25 @@ void add_matrices_menu() {
     double time_pool = get_time_ms() - start_pool;
 
     // Method 2: Fork-based (creating new processes)
-    printf("\n[2] Using FORK (new processes per element)...\n");
+    printf("\n[2] Using FORK (bounded row blocks, MAP_SHARED result)...\n");
     double start_fork = get_time_ms();
     Matrix *result_fork = add_matrices_with_processes(m1, m2);
     double time_fork = get_time_ms() - start_fork;
+    free_matrix(result_fork);
     
     // Method 3: OpenMP (threading)
     printf("\n[3] Using OpenMP (threading)...\n");
     double start_omp = get_time_ms();
     Matrix *result_omp = add_matrices_openmp(m1, m2);
     double time_omp = get_time_ms() - start_omp;
+    free_matrix(result_omp);
 
     // Method 4: Single-threaded
     printf("\n[4] Using Single-threaded...\n");
     double start_single = get_time_ms();
     Matrix *result_single = add_matrices_single(m1, m2);
     double time_single = get_time_ms() - start_single;
+    free_matrix(result_single);
 
     printf("\n=== PERFORMANCE COMPARISON ===\n");
     printf("Worker Pool time:     %.2f ms  (Speedup: %.2fx)\n", time_pool, time_single / time_pool);
@@ -160,15 +173,9 @@ void add_matrices_menu() {
     if (result_pool) {
         printf("\nResult:\n");
         print_matrix(result_pool);
-        if (matrix_count < MAX_MATRICES) {
-            matrices[matrix_count++] = result_pool;
-            printf("Result saved to memory as '%s'.\n", result_pool->name);
-        }
+        registry_add(result_pool);
+        printf("Result saved to memory as '%s'.\n", result_pool->name);
     }
-
-    if (result_fork) free_matrix(result_fork);
-    if (result_omp) free_matrix(result_omp);
-    if (result_single) free_matrix(result_single);
 }
 
 void subtract_matrices_menu() {
@@ -183,27 +190,37 @@ void subtract_matrices_menu() {
         return;
     }
 
-    printf("\n=== SUBTRACTION OPERATION - 3-WAY COMPARISON ===\n");
+    printf("\n=== SUBTRACTION OPERATION - 4-WAY COMPARISON ===\n");
+
+    // Worker Pool
+    printf("\n[1] Using WORKER POOL (persistent processes)...\n");
+    double start_pool = get_time_ms();
+    Matrix *result_pool = subtract_matrices_with_pool(m1, m2);
+    double time_pool = get_time_ms() - start_pool;
+    free_matrix(result_pool);
 
     // Fork-based
-    printf("\n[1] Using FORK (new processes)...\n");
+    printf("\n[2] Using FORK (bounded row blocks, MAP_SHARED result)...\n");
     double start_fork = get_time_ms();
     Matrix *result_fork = subtract_matrices_with_processes(m1, m2);
     double time_fork = get_time_ms() - start_fork;
     
     // OpenMP
-    printf("\n[2] Using OpenMP...\n");
+    printf("\n[3] Using OpenMP...\n");
     double start_omp = get_time_ms();
     Matrix *result_omp = subtract_matrices_openmp(m1, m2);
     double time_omp = get_time_ms() - start_omp;
+    free_matrix(result_omp);
 
     // Single-threaded
-    printf("\n[3] Using Single-threaded...\n");
+    printf("\n[4] Using Single-threaded...\n");
     double start_single = get_time_ms();
     Matrix *result_single = subtract_matrices_single(m1, m2);
     double time_single = get_time_ms() - start_single;
+    free_matrix(result_single);
 
     printf("\n=== PERFORMANCE COMPARISON ===\n");
+    printf("Worker Pool time:     %.2f ms  (Speedup: %.2fx)\n", time_pool, time_single / time_pool);
     printf("Fork-based time:      %.2f ms  (Speedup: %.2fx)\n", time_fork, time_single / time_fork);
     printf("OpenMP time:          %.2f ms  (Speedup: %.2fx)\n", time_omp, time_single / time_omp);
     printf("Single-threaded time: %.2f ms  (Baseline)\n", time_single);
@@ -211,14 +228,9 @@ void subtract_matrices_menu() {
     if (result_fork) {
         printf("\nResult:\n");
         print_matrix(result_fork);
-        if (matrix_count < MAX_MATRICES) {
-            matrices[matrix_count++] = result_fork;
-            printf("Result saved to memory as '%s'.\n", result_fork->name);
-        }
+        registry_add(result_fork);
+        printf("Result saved to memory as '%s'.\n", result_fork->name);
     }
-
-    if (result_omp) free_matrix(result_omp);
-    if (result_single) free_matrix(result_single);
 }
 
 void multiply_matrices_menu() {
@@ -233,47 +245,55 @@ void multiply_matrices_menu() {
         return;
     }
 
-    if (m1->cols > MAX_VECTOR_SIZE) {
-        printf("Error: Matrix dimension exceeds IPC buffer limit (%d).\n", MAX_VECTOR_SIZE);
-        return;
-    }
+    printf("\n=== MULTIPLICATION OPERATION - 5-WAY COMPARISON ===\n");
 
-    printf("\n=== MULTIPLICATION OPERATION - 3-WAY COMPARISON ===\n");
+    // Worker Pool
+    printf("\n[1] Using WORKER POOL (persistent processes)...\n");
+    double start_pool = get_time_ms();
+    Matrix *result_pool = multiply_matrices_with_pool(m1, m2);
+    double time_pool = get_time_ms() - start_pool;
+    free_matrix(result_pool);
 
     // Fork-based
-    printf("\n[1] Using FORK (new processes)...\n");
+    printf("\n[2] Using FORK (bounded row blocks, MAP_SHARED result)...\n");
     double start_fork = get_time_ms();
     Matrix *result_fork = multiply_matrices_with_processes(m1, m2);
     double time_fork = get_time_ms() - start_fork;
     
     // OpenMP
-    printf("\n[2] Using OpenMP...\n");
+    printf("\n[3] Using OpenMP...\n");
     double start_omp = get_time_ms();
     Matrix *result_omp = multiply_matrices_openmp(m1, m2);
     double time_omp = get_time_ms() - start_omp;
+    free_matrix(result_omp);
+
+    // Strassen
+    printf("\n[4] Using Strassen (OpenMP tasks)...\n");
+    double start_strassen = get_time_ms();
+    Matrix *result_strassen = multiply_matrices_strassen(m1, m2);
+    double time_strassen = get_time_ms() - start_strassen;
+    free_matrix(result_strassen);
 
     // Single-threaded
-    printf("\n[3] Using Single-threaded...\n");
+    printf("\n[5] Using Single-threaded...\n");
     double start_single = get_time_ms();
     Matrix *result_single = multiply_matrices_single(m1, m2);
     double time_single = get_time_ms() - start_single;
+    free_matrix(result_single);
 
     printf("\n=== PERFORMANCE COMPARISON ===\n");
+    printf("Worker Pool time:     %.2f ms  (Speedup: %.2fx)\n", time_pool, time_single / time_pool);
     printf("Fork-based time:      %.2f ms  (Speedup: %.2fx)\n", time_fork, time_single / time_fork);
     printf("OpenMP time:          %.2f ms  (Speedup: %.2fx)\n", time_omp, time_single / time_omp);
+    printf("Strassen time:        %.2f ms  (Speedup: %.2fx)\n", time_strassen, time_single / time_strassen);
     printf("Single-threaded time: %.2f ms  (Baseline)\n", time_single);
 
     if (result_fork) {
         printf("\nResult:\n");
         print_matrix(result_fork);
-        if (matrix_count < MAX_MATRICES) {
-            matrices[matrix_count++] = result_fork;
-            printf("Result saved to memory as '%s'.\n", result_fork->name);
-        }
+        registry_add(result_fork);
+        printf("Result saved to memory as '%s'.\n", result_fork->name);
     }
-
-    if (result_omp) free_matrix(result_omp);
-    if (result_single) free_matrix(result_single);
 }
 
 void determinant_menu() {
@@ -285,38 +305,49 @@ void determinant_menu() {
         return;
     }
 
-    printf("\n=== DETERMINANT CALCULATION - 3-WAY COMPARISON ===\n");
+    printf("\n=== DETERMINANT CALCULATION - 4-WAY COMPARISON ===\n");
     printf("Matrix: %s (%dx%d)\n\n", m->name, m->rows, m->cols);
 
+    // Worker Pool
+    printf("[1] Using WORKER POOL (persistent processes)...\n");
+    double start_pool = get_time_ms();
+    double det_pool = determinant_with_pool(m);
+    double time_pool = get_time_ms() - start_pool;
+
     // Multi-process
-    printf("[1] Using Multi-processing (fork)...\n");
+    printf("[2] Using FORK (blocked LU on a MAP_SHARED copy)...\n");
     double start_mp = get_time_ms();
     double det_mp = determinant_parallel(m);
     double time_mp = get_time_ms() - start_mp;
 
     // OpenMP
-    printf("[2] Using OpenMP...\n");
+    printf("[3] Using OpenMP...\n");
     double start_omp = get_time_ms();
     double det_omp = determinant_openmp(m);
     double time_omp = get_time_ms() - start_omp;
 
     // Single-threaded
-    printf("[3] Using Single-threaded...\n");
+    printf("[4] Using Single-threaded...\n");
     double start_single = get_time_ms();
     double det_single = determinant_single(m);
     double time_single = get_time_ms() - start_single;
 
     printf("\n=== PERFORMANCE COMPARISON ===\n");
+    printf("Worker Pool time:     %.2f ms  (Speedup: %.2fx)\n", time_pool, time_single / time_pool);
     printf("Multi-process time:   %.2f ms  (Speedup: %.2fx)\n", time_mp, time_single / time_mp);
     printf("OpenMP time:          %.2f ms  (Speedup: %.2fx)\n", time_omp, time_single / time_omp);
     printf("Single-threaded time: %.2f ms  (Baseline)\n", time_single);
     
     printf("\n=== VERIFICATION ===\n");
+    printf("Worker Pool result:   %.6f\n", det_pool);
     printf("Multi-process result: %.6f\n", det_mp);
     printf("OpenMP result:        %.6f\n", det_omp);
     printf("Single-thread result: %.6f\n", det_single);
     
-    if (fabs(det_mp - det_single) < 1e-6 && fabs(det_omp - det_single) < 1e-6) {
+    // Every backend runs pivoted LU, but they block and order the updates
+    // differently, so the rounding differs; compare relatively
+    if (values_agree(det_pool, det_single) && values_agree(det_mp, det_single) &&
+        values_agree(det_omp, det_single)) {
         printf("✅ All methods agree!\n");
     } else {
         printf("⚠️  Warning: Results differ!\n");
@@ -341,10 +372,19 @@ void eigenvalues_menu() {
     int num_eigen = get_int_input("How many eigenvalues to compute? (1 to %d): ", 
                                    1, m->rows);
 
-    printf("\n=== 3-WAY COMPARISON ===\n");
+    printf("\n=== 5-WAY COMPARISON ===\n");
+
+    // Worker Pool
+    printf("\n[1] Using WORKER POOL (persistent processes)...\n");
+    double eigenvalue_pool = 0.0;
+    double *eigenvector_pool = calloc(m->rows, sizeof(double));
+    
+    double start_pool = get_time_ms();
+    compute_eigen_with_pool(m, &eigenvalue_pool, eigenvector_pool);
+    double time_pool = get_time_ms() - start_pool;
 
     // Multi-processing
-    printf("\n[1] Using Multi-processing (fork + pipes)...\n");
+    printf("\n[2] Using FORK (children kept per solve, MAP_SHARED vector)...\n");
     double *eigenvalues_mp = malloc(num_eigen * sizeof(double));
     double **eigenvectors_mp = malloc(num_eigen * sizeof(double*));
     for (int i = 0; i < num_eigen; i++) {
@@ -358,43 +398,87 @@ void eigenvalues_menu() {
     send_status_via_fifo("EIGEN_MP_COMPLETE");
 
     // OpenMP
-    printf("\n[2] Using OpenMP (threading)...\n");
+    printf("\n[3] Using OpenMP (threading)...\n");
+    if (eigen_uses_jacobi(m, num_eigen)) {
+        printf("    Symmetric input: using the parallel Jacobi solver\n");
+    }
     double start_omp = get_time_ms();
     EigenResult *result_omp = compute_eigen_parallel(m, num_eigen);
     double time_omp = get_time_ms() - start_omp;
 
+    // Block subspace iteration
+    printf("\n[4] Using block subspace iteration (OpenMP + GEMM)...\n");
+    double start_sub = get_time_ms();
+    EigenResult *result_sub = subspace_iteration(m, num_eigen, 1000, 1e-8, 1);
+    double time_sub = get_time_ms() - start_sub;
+    if (result_sub) {
+        int converged = 0;
+        double worst = 0.0;
+        for (int i = 0; i < result_sub->num_eigenvalues; i++) {
+            if (result_sub->converged[i] > 0) converged++;
+            if (result_sub->residuals[i] > worst) worst = result_sub->residuals[i];
+        }
+        printf("    %d/%d pairs converged, max residual %.2e\n",
+               converged, result_sub->num_eigenvalues, worst);
+    }
+
     // Single-threaded
-    printf("\n[3] Using Single-threaded...\n");
+    printf("\n[5] Using Single-threaded...\n");
     double start_single = get_time_ms();
     EigenResult *result_single = compute_eigen_single(m, num_eigen);
     double time_single = get_time_ms() - start_single;
 
     printf("\n=== PERFORMANCE COMPARISON ===\n");
+    printf("Worker Pool time:     %.2f ms  (Speedup: %.2fx)\n", time_pool, time_single / time_pool);
     printf("Multi-process time:   %.2f ms  (Speedup: %.2fx)\n", time_mp, time_single / time_mp);
     printf("OpenMP time:          %.2f ms  (Speedup: %.2fx)\n", time_omp, time_single / time_omp);
+    printf("Subspace time:        %.2f ms  (Speedup: %.2fx)\n", time_sub, time_single / time_sub);
     printf("Single-threaded time: %.2f ms  (Baseline)\n", time_single);
 
-    printf("\n=== RESULTS (Multi-Processing) ===\n");
-    for (int i = 0; i < num_eigen; i++) {
-        printf("\nEigenvalue %d: %.6f\n", i + 1, eigenvalues_mp[i]);
-        
-        int has_vector = 0;
-        for (int j = 0; j < m->rows; j++) {
-            if (fabs(eigenvectors_mp[i][j]) > 1e-10) {
-                has_vector = 1;
-                break;
-            }
+    // The pool and fork paths only find the dominant pair; check it against
+    // the top eigenvalue of the OpenMP solver
+    printf("\n=== VERIFICATION (dominant eigenvalue) ===\n");
+    printf("Worker Pool result:   %.6f\n", eigenvalue_pool);
+    printf("Multi-process result: %.6f\n", eigenvalues_mp[0]);
+    if (result_omp && result_omp->eigenvalues_imag[0] != 0.0) {
+        printf("OpenMP result:        %.6f %c %.6fi\n", result_omp->eigenvalues[0],
+               result_omp->eigenvalues_imag[0] < 0 ? '-' : '+', fabs(result_omp->eigenvalues_imag[0]));
+        printf("⚠️  Complex dominant pair: power iteration cannot converge to it\n");
+    } else if (result_omp) {
+        printf("OpenMP result:        %.6f\n", result_omp->eigenvalues[0]);
+        if (values_agree(eigenvalue_pool, result_omp->eigenvalues[0]) &&
+            values_agree(eigenvalues_mp[0], result_omp->eigenvalues[0])) {
+            printf("✅ All methods agree!\n");
+        } else {
+            printf("⚠️  Warning: Results differ!\n");
         }
-        
-        if (has_vector) {
-            printf("Eigenvector %d: [", i + 1);
-            for (int j = 0; j < m->rows; j++) {
-                printf("%.4f", eigenvectors_mp[i][j]);
-                if (j < m->rows - 1) printf(", ");
+    }
+
+    if (result_omp) print_eigen_result(result_omp, m->rows);
+    else printf("\nThe OpenMP eigen solver did not converge.\n");
+
+    // Full spectrum, including complex pairs
+    double *spectrum_re = malloc(m->rows * sizeof(double));
+    double *spectrum_im = malloc(m->rows * sizeof(double));
+    double start_qr = get_time_ms();
+    int sweeps = qr_algorithm_eigenvalues(m, spectrum_re, spectrum_im, 30 * m->rows, 1e-14);
+    double time_qr = get_time_ms() - start_qr;
+    if (sweeps < 0) {
+        printf("\nShifted QR did not converge.\n");
+    } else {
+        printf("\n=== ALL EIGENVALUES (Hessenberg + shifted QR, %d sweeps, %.2f ms) ===\n",
+               sweeps, time_qr);
+        for (int i = 0; i < m->rows; i++) {
+            if (spectrum_im[i] == 0.0) {
+                printf("  %d: %.6f\n", i + 1, spectrum_re[i]);
+            } else {
+                printf("  %d: %.6f %c %.6fi\n", i + 1, spectrum_re[i],
+                       spectrum_im[i] < 0 ? '-' : '+', fabs(spectrum_im[i]));
             }
-            printf("]\n");
         }
     }
+    free(spectrum_re);
+    free(spectrum_im);
 
     // Cleanup
     for (int i = 0; i < num_eigen; i++) {
@@ -402,16 +486,41 @@ void eigenvalues_menu() {
     }
     free(eigenvectors_mp);
     free(eigenvalues_mp);
+    free(eigenvector_pool);
     
     if (result_omp) free_eigen_result(result_omp);
+    if (result_sub) free_eigen_result(result_sub);
     if (result_single) free_eigen_result(result_single);
 }
 
+// `--batch SCRIPT [CONFIG]`: quiet config, no pool, no menus
+static int run_batch_mode(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s --batch SCRIPT [CONFIG]\n", argv[0]);
+        return 1;
+    }
+
+    init_default_config();
+    load_config_quiet(argc > 3 ? argv[3] : "matrix_config.txt");
+    Config *cfg = get_config();
+    fork_children = cfg->fork_children;
+    text_save_precision = cfg->save_precision;
+    strassen_crossover = cfg->strassen_crossover;
+
+    int status = run_batch_script(argv[2]);
+    registry_clear();
+    return status;
+}
+
 int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        return run_batch_mode(argc, argv);
+    }
+
     printf("===========================================\n");
     printf(" Matrix Operations with Multi-Processing\n");
     printf(" Real-Time & Embedded Systems Project\n");
-    printf(" ✅ OPTIMIZED VERSION WITH 3-WAY COMPARISON\n");
+    printf(" ✅ OPTIMIZED VERSION WITH MULTI-BACKEND COMPARISON\n");
     printf("===========================================\n\n");
 
     const char *config_file = (argc > 1) ? argv[1] : "matrix_config.txt";
@@ -425,6 +534,9 @@ int main(int argc, char *argv[]) {
     printf("\nInitializing system with %d workers...\n", cfg->worker_pool_size);
     init_worker_pool(cfg->worker_pool_size);
     max_idle_time = cfg->max_idle_time;
+    fork_children = cfg->fork_children;
+    text_save_precision = cfg->save_precision;
+    strassen_crossover = cfg->strassen_crossover;
 
     if (strlen(cfg->matrix_directory) > 0) {
         printf("\n[AUTO-LOAD] Loading matrices from: %s\n", cfg->matrix_directory);
@@ -459,9 +571,7 @@ int main(int argc, char *argv[]) {
                 printf("\nCleaning up worker pool...\n");
                 cleanup_worker_pool();
                 printf("Freeing matrices...\n");
-                for (int i = 0; i < matrix_count; i++) {
-                    free_matrix(matrices[i]);
-                }
+                registry_clear();
                 printf("Goodbye!\n");
                 exit(0);
 
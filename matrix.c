@@ -1,35 +1,122 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include <string.h>
+#include <sys/mman.h>
 #include "matrix.h"
-
-// ===== Global Variables =====
-Matrix *matrices[MAX_MATRICES];
-int matrix_count = 0;
+#include "matrix_bin.h"
+#include "matrix_text.h"
+#include "registry.h"
 
 // ===== Helper Functions =====
-Matrix *create_matrix(int rows, int cols, const char *name) {
-    Matrix *m = malloc(sizeof(Matrix));
+int matrix_stride_for(int cols) {
+    int per_line = MATRIX_ALIGNMENT / (int)sizeof(double);
+    return ((cols + per_line - 1) / per_line) * per_line;
+}
+
+// ===== Shared Buffers =====
+// `storage` is the aligned heap block, or NULL when the elements live in
+// `mapping` instead.
+struct MatrixBuffer {
+    atomic_int refs;
+    double *storage;
+    void *mapping;
+    size_t mapping_bytes;
+};
+
+static MatrixBuffer *new_buffer(double *storage, void *mapping, size_t mapping_bytes) {
+    MatrixBuffer *b = malloc(sizeof(MatrixBuffer));
+    if (!b) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    atomic_init(&b->refs, 1);
+    b->storage = storage;
+    b->mapping = mapping;
+    b->mapping_bytes = mapping_bytes;
+    return b;
+}
+
+static void release_buffer(MatrixBuffer *b) {
+    if (atomic_fetch_sub_explicit(&b->refs, 1, memory_order_acq_rel) != 1) return;
+    if (b->mapping)
+        munmap(b->mapping, b->mapping_bytes);
+    else
+        free(b->storage);
+    free(b);
+}
+
+static double *alloc_storage(int rows, int stride) {
+    size_t bytes = (size_t)rows * (size_t)stride * sizeof(double);
+    double *storage;
+    if (posix_memalign((void **)&storage, MATRIX_ALIGNMENT,
+                       bytes > 0 ? bytes : MATRIX_ALIGNMENT) != 0) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    return storage;
+}
+
+// Header and row table share one allocation; the rows point into `storage`.
+static Matrix *new_header(int rows, int cols, int stride, double *storage,
+                          MatrixBuffer *buffer, const char *name) {
+    Matrix *m = malloc(sizeof(Matrix) + (size_t)rows * sizeof(double *));
     if (!m) {
         printf("Memory allocation failed.\n");
         exit(1);
     }
-    strcpy(m->name, name);
+    snprintf(m->name, sizeof(m->name), "%s", name);
     m->rows = rows;
     m->cols = cols;
+    m->stride = stride;
+    m->data = (double **)(m + 1);
+    m->storage = storage;
+    m->buffer = buffer;
 
-    m->data = malloc(rows * sizeof(double *));
     for (int i = 0; i < rows; i++) {
-        m->data[i] = calloc(cols, sizeof(double));
+        m->data[i] = MATRIX_ROW(m, i);
     }
     return m;
 }
 
-void free_matrix(Matrix *m) {
+Matrix *create_matrix(int rows, int cols, const char *name) {
+    int stride = matrix_stride_for(cols);
+    double *storage = alloc_storage(rows, stride);
+    memset(storage, 0, (size_t)rows * (size_t)stride * sizeof(double));
+    return new_header(rows, cols, stride, storage, new_buffer(storage, NULL, 0), name);
+}
+
+// Wrap rows already laid out at `stride` inside an mmap'd region; the matrix
+// takes ownership of the mapping.
+Matrix *adopt_matrix_mapping(int rows, int cols, int stride, void *mapping,
+                             size_t mapping_bytes, size_t data_offset, const char *name) {
+    return new_header(rows, cols, stride, (double *)((char *)mapping + data_offset),
+                      new_buffer(NULL, mapping, mapping_bytes), name);
+}
+
+Matrix *matrix_share(Matrix *m, const char *name) {
+    atomic_fetch_add_explicit(&m->buffer->refs, 1, memory_order_relaxed);
+    return new_header(m->rows, m->cols, m->stride, m->storage, m->buffer, name);
+}
+
+void matrix_make_writable(Matrix *m) {
+    // The acquire pairs with release_buffer, so a count of one means every
+    // other header is done with the elements.
+    if (atomic_load_explicit(&m->buffer->refs, memory_order_acquire) == 1) return;
+
+    double *storage = alloc_storage(m->rows, m->stride);
+    memcpy(storage, m->storage, (size_t)m->rows * (size_t)m->stride * sizeof(double));
+    release_buffer(m->buffer);
+    m->buffer = new_buffer(storage, NULL, 0);
+    m->storage = storage;
     for (int i = 0; i < m->rows; i++) {
-        free(m->data[i]);
+        m->data[i] = MATRIX_ROW(m, i);
     }
-    free(m->data);
+}
+
+void free_matrix(Matrix *m) {
+    if (!m) return;
+    release_buffer(m->buffer);
     free(m);
 }
 
@@ -43,46 +130,52 @@ void print_matrix(Matrix *m) {
 }
 
 void load_matrices_from_file(const char *filename) {
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        printf("Failed to open file: %s\n", filename);
+    // A binary file holds exactly one matrix
+    if (matrix_bin_path(filename)) {
+        char err[128];
+        Matrix *m = read_matrix_bin(filename, err, sizeof(err));
+        if (!m)
+            printf("Failed to load %s: %s\n", filename, err);
+        else
+            registry_add(m);
         return;
     }
 
-    while (!feof(fp)) {
-        char name[50];
-        int rows, cols;
-        if (fscanf(fp, "%s %d %d", name, &rows, &cols) != 3) break;
-
-        Matrix *m = create_matrix(rows, cols, name);
-        for (int i = 0; i < rows; i++)
-            for (int j = 0; j < cols; j++)
-                fscanf(fp, "%lf", &m->data[i][j]);
-
-        if (matrix_count < MAX_MATRICES)
-            matrices[matrix_count++] = m;
-
-        // Skip empty line
-        int c;
-        while ((c = fgetc(fp)) != EOF && c != '\n');
+    Matrix **loaded;
+    TextParseError err;
+    int n = parse_matrix_text_file(filename, &loaded, 0, &err);
+    if (n < 0) {
+        printf("Failed to open file: %s (%s)\n", filename, err.message);
+        return;
     }
-
-    fclose(fp);
+    for (int i = 0; i < n; i++)
+        registry_add(loaded[i]);
+    free(loaded);
+    if (err.line)
+        printf("[ERROR] %s:%ld:%ld: %s\n", filename, err.line, err.col, err.message);
 }
 
 // ===== Menu Options =====
 
-void enter_matrix() {
-    if (matrix_count >= MAX_MATRICES) {
-        printf("Memory full! Cannot store more matrices.\n");
-        return;
+// Print the registry as a numbered list; returns how many were listed
+static int list_matrices(int with_dims) {
+    int i = 0;
+    for (MatrixHandle h = registry_first(); h; h = registry_next(h)) {
+        Matrix *m = registry_get(h);
+        if (with_dims)
+            printf("%d. %s (%dx%d)\n", ++i, m->name, m->rows, m->cols);
+        else
+            printf("%d. %s\n", ++i, m->name);
     }
+    return i;
+}
 
+void enter_matrix() {
     char name[50];
     int rows, cols;
 
     printf("Enter matrix name: ");
-    scanf("%s", name);
+    scanf("%49s", name);
     printf("Enter number of rows: ");
     scanf("%d", &rows);
     printf("Enter number of columns: ");
@@ -95,75 +188,68 @@ void enter_matrix() {
         for (int j = 0; j < cols; j++)
             scanf("%lf", &m->data[i][j]);
 
-    matrices[matrix_count++] = m;
-    printf("Matrix '%s' saved in memory.\n", name);
+    registry_add(m);
+    printf("Matrix '%s' saved in memory.\n", m->name);
 }
 
 void display_matrix() {
-    if (matrix_count == 0) {
+    if (registry_count() == 0) {
         printf("No matrices in memory.\n");
         return;
     }
 
     printf("Available matrices:\n");
-    for (int i = 0; i < matrix_count; i++)
-        printf("%d. %s (%dx%d)\n", i + 1, matrices[i]->name,
-               matrices[i]->rows, matrices[i]->cols);
+    list_matrices(1);
 
     int choice;
     printf("Enter number to display: ");
     scanf("%d", &choice);
 
-    if (choice < 1 || choice > matrix_count) {
+    Matrix *m = registry_get(registry_nth(choice));
+    if (!m) {
         printf("Invalid choice.\n");
         return;
     }
 
-    print_matrix(matrices[choice - 1]);
+    print_matrix(m);
 }
 
 void delete_matrix() {
-    if (matrix_count == 0) {
+    if (registry_count() == 0) {
         printf("No matrices to delete.\n");
         return;
     }
 
     printf("Matrices in memory:\n");
-    for (int i = 0; i < matrix_count; i++)
-        printf("%d. %s\n", i + 1, matrices[i]->name);
+    list_matrices(0);
 
     int index;
     printf("Enter number of matrix to delete: ");
     scanf("%d", &index);
 
-    if (index < 1 || index > matrix_count) {
+    if (registry_remove(registry_nth(index)) != 0) {
         printf("Invalid choice.\n");
         return;
     }
 
-    free_matrix(matrices[index - 1]);
-    for (int i = index - 1; i < matrix_count - 1; i++)
-        matrices[i] = matrices[i + 1];
-    matrix_count--;
-
     printf("Matrix deleted successfully.\n");
 }
 
 void modify_matrix() {
-    if (matrix_count == 0) {
+    if (registry_count() == 0) {
         printf("No matrices to modify.\n");
         return;
     }
 
-    for (int i = 0; i < matrix_count; i++)
-        printf("%d. %s\n", i + 1, matrices[i]->name);
+    list_matrices(0);
 
     int choice;
     printf("Choose a matrix: ");
     scanf("%d", &choice);
-    if (choice < 1 || choice > matrix_count) return;
+    Matrix *m = registry_get(registry_nth(choice));
+    if (!m) return;
+    matrix_make_writable(m);
 
-    Matrix *m = matrices[choice - 1];
     int mode;
     printf("1. Modify full row\n2. Modify full column\n3. Modify one value\nChoice: ");
     scanf("%d", &mode);
@@ -196,10 +282,10 @@ void modify_matrix() {
 }
 
 void display_all_matrices() {
-    if (matrix_count == 0) {
+    if (registry_count() == 0) {
         printf("No matrices in memory.\n");
         return;
     }
-    for (int i = 0; i < matrix_count; i++)
-        print_matrix(matrices[i]);
+    for (MatrixHandle h = registry_first(); h; h = registry_next(h))
+        print_matrix(registry_get(h));
 }
@@ -1,21 +1,46 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include <stddef.h>
+
 // ===== Matrix Structure =====
+// Elements live in one MATRIX_ALIGNMENT-aligned block; each row starts at a
+// multiple of `stride` doubles so every row is itself cache-line aligned.
+// `data` is a row-pointer view into `storage` kept for element-wise callers.
+//
+// The elements belong to a reference-counted MatrixBuffer (heap block or
+// private file mapping) that several Matrix headers may share. Sharing is
+// copy-on-write: anything that writes through a header calls
+// matrix_make_writable first, which gives that header its own copy when the
+// buffer is shared. A single header must not be used from two threads while
+// it is being made writable.
+#define MATRIX_ALIGNMENT 64
+
+typedef struct MatrixBuffer MatrixBuffer;
+
 typedef struct {
     char name[50];
     int rows;
     int cols;
+    int stride;
+    double *storage;
     double **data;
+    MatrixBuffer *buffer;
 } Matrix;
 
-// ===== Global Storage =====
-#define MAX_MATRICES 50
-extern Matrix *matrices[MAX_MATRICES];
-extern int matrix_count;
+#define MATRIX_ROW(m, i) ((m)->storage + (size_t)(i) * (size_t)(m)->stride)
+#define MATRIX_AT(m, i, j) (MATRIX_ROW(m, i)[(j)])
 
 // ===== Basic Matrix Functions =====
 Matrix *create_matrix(int rows, int cols, const char *name);
+Matrix *adopt_matrix_mapping(int rows, int cols, int stride, void *mapping,
+                             size_t mapping_bytes, size_t data_offset, const char *name);
+int matrix_stride_for(int cols);
+// New header over m's elements; O(rows), no element is copied
+Matrix *matrix_share(Matrix *m, const char *name);
+// Unshare m's elements before writing to them
+void matrix_make_writable(Matrix *m);
+// Drops m's reference; the elements go with the last one
 void free_matrix(Matrix *m);
 void print_matrix(Matrix *m);
 
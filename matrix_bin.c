@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "matrix_bin.h"
+
+_Static_assert(sizeof(MatrixBinHeader) == MATRIX_BIN_HEADER_BYTES,
+               "binary header layout changed");
+_Static_assert(MATRIX_BIN_HEADER_BYTES % MATRIX_ALIGNMENT == 0,
+               "data block must stay aligned");
+
+// ===== Checksum =====
+// FNV-1a over 64-bit words in four interleaved lanes, folded at the end.
+// Lanes keep the multiplies independent; every chunk fed to the update must
+// be a multiple of four words so lane assignment does not depend on chunking.
+#define FNV_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+typedef struct {
+    uint64_t lane[4];
+} Checksum;
+
+static void checksum_init(Checksum *c) {
+    for (int l = 0; l < 4; l++) c->lane[l] = FNV_BASIS ^ (uint64_t)l;
+}
+
+static void checksum_update(Checksum *c, const void *data, size_t nwords) {
+    const char *p = data;
+    uint64_t h0 = c->lane[0], h1 = c->lane[1], h2 = c->lane[2], h3 = c->lane[3];
+    for (size_t i = 0; i + 4 <= nwords; i += 4) {
+        uint64_t w[4];
+        memcpy(w, p + i * sizeof(uint64_t), sizeof(w));
+        h0 = (h0 ^ w[0]) * FNV_PRIME;
+        h1 = (h1 ^ w[1]) * FNV_PRIME;
+        h2 = (h2 ^ w[2]) * FNV_PRIME;
+        h3 = (h3 ^ w[3]) * FNV_PRIME;
+    }
+    c->lane[0] = h0;
+    c->lane[1] = h1;
+    c->lane[2] = h2;
+    c->lane[3] = h3;
+}
+
+static uint64_t checksum_final(const Checksum *c) {
+    uint64_t h = FNV_BASIS;
+    for (int l = 0; l < 4; l++) h = (h ^ c->lane[l]) * FNV_PRIME;
+    return h;
+}
+
+// ===== Helpers =====
+int matrix_bin_path(const char *filename) {
+    size_t len = strlen(filename);
+    size_t ext = strlen(MATRIX_BIN_EXTENSION);
+    return len >= ext && strcmp(filename + len - ext, MATRIX_BIN_EXTENSION) == 0;
+}
+
+// Header sanity against the file size; returns an error string or NULL
+static const char *validate_header(const MatrixBinHeader *h, size_t file_bytes) {
+    if (memcmp(h->magic, MATRIX_BIN_MAGIC, sizeof(h->magic)) != 0) return "bad magic";
+    if (h->version != MATRIX_BIN_VERSION) return "unsupported version";
+    if (h->dtype != MATRIX_DTYPE_F64) return "unsupported dtype";
+    if (h->header_bytes != MATRIX_BIN_HEADER_BYTES) return "bad header size";
+    if (memchr(h->name, '\0', sizeof(h->name)) == NULL) return "unterminated name";
+    // Only the layout create_matrix produces; kernels copy at that stride
+    if (h->rows < 0 || h->cols < 0 || h->stride != matrix_stride_for(h->cols))
+        return "bad dimensions";
+    if (h->data_bytes != (uint64_t)h->rows * (uint64_t)h->stride * sizeof(double))
+        return "data size does not match dimensions";
+    if (h->data_bytes > file_bytes - h->header_bytes) return "file truncated";
+    return NULL;
+}
+
+// ===== Load =====
+Matrix *read_matrix_bin(const char *filename, char *err, size_t err_len) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        snprintf(err, err_len, "cannot open: %s", strerror(errno));
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        snprintf(err, err_len, "fstat() failed: %s", strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    size_t file_bytes = (size_t)st.st_size;
+    if (file_bytes < MATRIX_BIN_HEADER_BYTES) {
+        snprintf(err, err_len, "invalid binary matrix: file truncated");
+        close(fd);
+        return NULL;
+    }
+
+    // Private writable mapping: the matrix can be modified in memory like any
+    // other, pages are copied on first write and the file is left untouched
+    void *map = mmap(NULL, file_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        snprintf(err, err_len, "mmap() failed: %s", strerror(errno));
+        return NULL;
+    }
+
+    const MatrixBinHeader *h = map;
+    const char *bad = validate_header(h, file_bytes);
+    if (!bad) {
+        Checksum c;
+        checksum_init(&c);
+        checksum_update(&c, (const char *)map + h->header_bytes,
+                        h->data_bytes / sizeof(uint64_t));
+        if (checksum_final(&c) != h->checksum) bad = "checksum mismatch";
+    }
+    if (bad) {
+        snprintf(err, err_len, "invalid binary matrix: %s", bad);
+        munmap(map, file_bytes);
+        return NULL;
+    }
+
+    return adopt_matrix_mapping(h->rows, h->cols, h->stride, map, file_bytes,
+                                h->header_bytes, h->name);
+}
+
+// ===== Save =====
+// Rows are streamed at the matrix's own stride with the padding zeroed; the
+// header is written last once the checksum is known.
+int save_matrix_bin(Matrix *m, const char *filename, char *err, size_t err_len) {
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        snprintf(err, err_len, "cannot open for writing: %s", strerror(errno));
+        return -1;
+    }
+
+    MatrixBinHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MATRIX_BIN_MAGIC, sizeof(h.magic));
+    h.version = MATRIX_BIN_VERSION;
+    h.dtype = MATRIX_DTYPE_F64;
+    h.rows = m->rows;
+    h.cols = m->cols;
+    h.stride = m->stride;
+    h.header_bytes = MATRIX_BIN_HEADER_BYTES;
+    h.data_bytes = (uint64_t)m->rows * m->stride * sizeof(double);
+    snprintf(h.name, sizeof(h.name), "%s", m->name);
+
+    double *row = calloc((size_t)m->stride > 0 ? (size_t)m->stride : 1, sizeof(double));
+    if (!row) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    Checksum c;
+    checksum_init(&c);
+    int ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+    for (int i = 0; ok && i < m->rows; i++) {
+        memcpy(row, MATRIX_ROW(m, i), (size_t)m->cols * sizeof(double));
+        checksum_update(&c, row, (size_t)m->stride);
+        ok = fwrite(row, sizeof(double), (size_t)m->stride, fp) == (size_t)m->stride;
+    }
+    free(row);
+
+    if (ok) {
+        h.checksum = checksum_final(&c);
+        ok = fseek(fp, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, fp) == 1;
+    }
+    if (fclose(fp) != 0) ok = 0;
+    if (!ok) {
+        snprintf(err, err_len, "write failed: %s", strerror(errno));
+        return -1;
+    }
+    return 0;
+}
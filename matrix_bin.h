@@ -0,0 +1,43 @@
+#ifndef MATRIX_BIN_H
+#define MATRIX_BIN_H
+
+#include <stdint.h>
+#include "matrix.h"
+
+// ===== Binary Matrix Format =====
+// A fixed 128-byte header followed by the rows exactly as a Matrix stores
+// them: `stride` doubles per row, padding zeroed, starting at a 64-byte
+// aligned offset. Values are native-endian IEEE doubles. Loading maps the
+// file privately and points the Matrix at the mapping, so nothing is parsed
+// or copied; writes to the loaded matrix never reach the file.
+//
+// The checksum covers the data block only and is verified on load.
+#define MATRIX_BIN_MAGIC "MTXBIN\r\n"
+#define MATRIX_BIN_VERSION 1
+#define MATRIX_BIN_HEADER_BYTES 128
+#define MATRIX_BIN_EXTENSION ".bin"
+
+enum { MATRIX_DTYPE_F64 = 1 };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t dtype;
+    int32_t rows;
+    int32_t cols;
+    int32_t stride;
+    uint32_t header_bytes;
+    uint64_t data_bytes;
+    uint64_t checksum;
+    char name[64];
+    uint8_t reserved[16];
+} MatrixBinHeader;
+
+// True when the filename selects the binary format
+int matrix_bin_path(const char *filename);
+
+// Both report failure (NULL / -1) with a message in err; neither prints
+Matrix *read_matrix_bin(const char *filename, char *err, size_t err_len);
+int save_matrix_bin(Matrix *m, const char *filename, char *err, size_t err_len);
+
+#endif
@@ -0,0 +1,765 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
+#include "matrix_text.h"
+
+// ===== Tokens =====
+static const unsigned char is_space[256] = {
+    [' '] = 1, ['\t'] = 1, ['\n'] = 1, ['\v'] = 1, ['\f'] = 1, ['\r'] = 1
+};
+
+// Advance *pos to the start of the next token in [*pos, end); returns its
+// length, or 0 when the range holds no more tokens
+static size_t next_token(const char *buf, size_t *pos, size_t end) {
+    size_t p = *pos;
+    while (p < end && is_space[(unsigned char)buf[p]]) p++;
+    size_t q = p;
+    while (q < end && !is_space[(unsigned char)buf[q]]) q++;
+    *pos = p;
+    return q - p;
+}
+
+// ===== Number Parsing =====
+// Clinger's fast path: a decimal with at most 19 significant digits whose
+// mantissa fits in 53 bits and whose power of ten is itself exact is
+// correctly rounded by a single multiply or divide. Everything else (long
+// mantissas, large exponents, inf/nan, hex) goes through strtod.
+static const double pow10_exact[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int parse_double_slow(const char *tok, size_t len, double *out) {
+    char small[64];
+    char *copy = len < sizeof(small) ? small : malloc(len + 1);
+    if (!copy) return -1;
+    memcpy(copy, tok, len);
+    copy[len] = '\0';
+    char *endp;
+    *out = strtod(copy, &endp);
+    int ok = endp == copy + len;
+    if (copy != small) free(copy);
+    return ok ? 0 : -1;
+}
+
+static int parse_double(const char *tok, size_t len, double *out) {
+    const char *s = tok, *end = tok + len;
+    int neg = 0;
+    if (s < end && (*s == '+' || *s == '-')) neg = (*s++ == '-');
+
+    uint64_t mant = 0;
+    int digits = 0, exp10 = 0, seen = 0, inexact = 0;
+    for (; s < end && (unsigned)(*s - '0') < 10; s++) {
+        int d = *s - '0';
+        seen = 1;
+        if (digits < 19) {
+            mant = mant * 10 + (uint64_t)d;
+            if (mant) digits++;
+        } else {
+            exp10++;
+            if (d) inexact = 1;
+        }
+    }
+    if (s < end && *s == '.') {
+        for (s++; s < end && (unsigned)(*s - '0') < 10; s++) {
+            int d = *s - '0';
+            seen = 1;
+            if (digits < 19) {
+                mant = mant * 10 + (uint64_t)d;
+                if (mant) digits++;
+                exp10--;
+            } else if (d) {
+                inexact = 1;
+            }
+        }
+    }
+    if (!seen) return parse_double_slow(tok, len, out);
+
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        s++;
+        int eneg = 0;
+        if (s < end && (*s == '+' || *s == '-')) eneg = (*s++ == '-');
+        if (s == end || (unsigned)(*s - '0') >= 10) return -1;
+        int e = 0;
+        for (; s < end && (unsigned)(*s - '0') < 10; s++) {
+            if (e < 100000) e = e * 10 + (*s - '0');
+        }
+        exp10 += eneg ? -e : e;
+    }
+    if (s != end) return parse_double_slow(tok, len, out);
+
+    if (!inexact && mant <= (1ULL << 53)) {
+        double v = (double)mant;
+        if (mant == 0 || exp10 == 0) {
+            *out = neg ? -v : v;
+            return 0;
+        }
+        if (exp10 > 0 && exp10 <= 22) {
+            *out = neg ? -(v * pow10_exact[exp10]) : v * pow10_exact[exp10];
+            return 0;
+        }
+        if (exp10 < 0 && exp10 >= -22) {
+            *out = neg ? -(v / pow10_exact[-exp10]) : v / pow10_exact[-exp10];
+            return 0;
+        }
+        // 1234e25: move the excess power into the mantissa while it stays exact
+        if (exp10 > 22 && exp10 <= 22 + 15) {
+            uint64_t m2 = mant;
+            int k = exp10 - 22;
+            while (k-- > 0 && m2 <= (1ULL << 53)) m2 *= 10;
+            if (m2 <= (1ULL << 53)) {
+                v = (double)m2 * pow10_exact[22];
+                *out = neg ? -v : v;
+                return 0;
+            }
+        }
+    }
+    return parse_double_slow(tok, len, out);
+}
+
+static int parse_count(const char *tok, size_t len, int *out) {
+    size_t i = (len > 0 && tok[0] == '+') ? 1 : 0;
+    if (i == len) return -1;
+    long long v = 0;
+    for (; i < len; i++) {
+        if ((unsigned)(tok[i] - '0') >= 10) return -1;
+        v = v * 10 + (tok[i] - '0');
+        if (v > INT_MAX) return -1;
+    }
+    *out = (int)v;
+    return 0;
+}
+
+// ===== Chunks and Blocks =====
+// Every TEXT_PARSE_MARK-th token of a chunk has its offset recorded, so the
+// header walk can land near a block header without reading the body before it
+#define TEXT_PARSE_MARK 256
+
+typedef struct {
+    size_t begin;           // always at a line start
+    size_t end;
+    uint64_t first_token;   // global index of the chunk's first token
+    uint64_t tokens;
+    size_t *marks;          // offset of local token k * TEXT_PARSE_MARK
+    long first_line;
+    long lines;
+} Chunk;
+
+typedef struct {
+    Matrix *m;
+    uint64_t first_value;   // global token index of element (0,0)
+    uint64_t count;
+} Block;
+
+typedef struct {
+    uint64_t token;         // global token index; blocks ending after it are dropped
+    size_t pos;             // byte offset, for line:col
+    char message[128];
+} ParseFailure;
+
+static void record_failure(ParseFailure *f, uint64_t token, size_t pos, const char *fmt, ...) {
+    if (f->token <= token) return;
+    f->token = token;
+    f->pos = pos;
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(f->message, sizeof(f->message), fmt, ap);
+    va_end(ap);
+}
+
+// Tokens quoted in messages are cut to this many bytes
+#define SHOWN(len) ((len) > 32 ? 32 : (int)(len))
+
+// Forward-only walk over the token stream used to read block headers. It
+// jumps whole chunks and then to the nearest mark, so reaching the next
+// header reads fewer than TEXT_PARSE_MARK tokens of the body before it.
+typedef struct {
+    int chunk;
+    size_t pos;
+    uint64_t index;
+} Cursor;
+
+static size_t token_at(const char *buf, const Chunk *chunks, int nchunks, Cursor *c,
+                       uint64_t index, size_t *pos) {
+    while (c->chunk < nchunks &&
+           index >= chunks[c->chunk].first_token + chunks[c->chunk].tokens) {
+        c->chunk++;
+        if (c->chunk < nchunks) {
+            c->pos = chunks[c->chunk].begin;
+            c->index = chunks[c->chunk].first_token;
+        }
+    }
+    if (c->chunk == nchunks) return 0;
+    const Chunk *ch = &chunks[c->chunk];
+    uint64_t mark = (index - ch->first_token) / TEXT_PARSE_MARK;
+    if (ch->first_token + mark * TEXT_PARSE_MARK > c->index) {
+        c->index = ch->first_token + mark * TEXT_PARSE_MARK;
+        c->pos = ch->marks[mark];
+    }
+    size_t end = ch->end;
+    size_t len;
+    for (;;) {
+        len = next_token(buf, &c->pos, end);
+        if (c->index == index) break;
+        c->pos += len;
+        c->index++;
+    }
+    *pos = c->pos;
+    return len;
+}
+
+static void locate(const char *buf, size_t len, const Chunk *chunks, int nchunks,
+                   size_t pos, TextParseError *err) {
+    int c = 0;
+    while (c + 1 < nchunks && chunks[c + 1].begin <= pos) c++;
+    long line = chunks[c].first_line;
+    size_t line_start = chunks[c].begin;
+    for (size_t p = chunks[c].begin; p < pos && p < len; p++) {
+        if (buf[p] == '\n') {
+            line++;
+            line_start = p + 1;
+        }
+    }
+    err->line = line;
+    err->col = (long)(pos - line_start) + 1;
+}
+
+// Parse the value tokens of one chunk into whichever blocks they belong to
+static void parse_chunk(const char *buf, const Chunk *ch, const Block *blocks, int nblocks,
+                        ParseFailure *fail) {
+    // First block whose values are not all before this chunk
+    int lo = 0, hi = nblocks;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (blocks[mid].first_value + blocks[mid].count <= ch->first_token) lo = mid + 1;
+        else hi = mid;
+    }
+    int b = lo;
+    if (b == nblocks) return;
+
+    uint64_t g = ch->first_token;
+    size_t pos = ch->begin;
+    int row = -1, col = 0;
+    for (uint64_t t = 0; t < ch->tokens; t++, g++) {
+        size_t len = next_token(buf, &pos, ch->end);
+        const char *tok = buf + pos;
+        pos += len;
+
+        while (g >= blocks[b].first_value + blocks[b].count) {
+            if (++b == nblocks) return;
+            row = -1;
+        }
+        if (g < blocks[b].first_value) continue;
+
+        Matrix *m = blocks[b].m;
+        if (row < 0) {
+            uint64_t e = g - blocks[b].first_value;
+            row = (int)(e / (uint64_t)m->cols);
+            col = (int)(e % (uint64_t)m->cols);
+        }
+        if (parse_double(tok, len, &MATRIX_AT(m, row, col)) != 0) {
+            record_failure(fail, g, (size_t)(tok - buf), "invalid number '%.*s'",
+                           SHOWN(len), tok);
+            return;
+        }
+        if (++col == m->cols) {
+            col = 0;
+            row++;
+        }
+    }
+}
+
+// ===== Entry Point =====
+int parse_matrix_text_file(const char *filename, Matrix ***out, int max_matrices,
+                           TextParseError *err) {
+    *out = NULL;
+    err->line = 0;
+    err->col = 0;
+    err->message[0] = '\0';
+
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        snprintf(err->message, sizeof(err->message), "cannot open: %s", strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        snprintf(err->message, sizeof(err->message), "fstat() failed: %s", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    size_t len = (size_t)st.st_size;
+    if (len == 0) {
+        close(fd);
+        return 0;
+    }
+    if (max_matrices <= 0) max_matrices = INT_MAX;
+    const char *buf = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (buf == MAP_FAILED) {
+        snprintf(err->message, sizeof(err->message), "mmap() failed: %s", strerror(errno));
+        return -1;
+    }
+    madvise((void *)buf, len, MADV_SEQUENTIAL);
+
+    // Cut on line boundaries; small files stay in one chunk
+    int nchunks = omp_get_max_threads();
+    if ((size_t)nchunks > len / TEXT_PARSE_MIN_CHUNK) nchunks = (int)(len / TEXT_PARSE_MIN_CHUNK);
+    if (nchunks < 1) nchunks = 1;
+    Chunk *chunks = calloc((size_t)nchunks, sizeof(Chunk));
+    if (!chunks) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    size_t prev = 0;
+    for (int c = 0; c < nchunks; c++) {
+        size_t cut = len;
+        if (c + 1 < nchunks) {
+            cut = len / (size_t)nchunks * (size_t)(c + 1);
+            if (cut < prev) cut = prev;
+            const char *nl = memchr(buf + cut, '\n', len - cut);
+            cut = nl ? (size_t)(nl - buf) + 1 : len;
+        }
+        chunks[c].begin = prev;
+        chunks[c].end = cut;
+        prev = cut;
+    }
+
+    #pragma omp parallel for schedule(static, 1)
+    for (int c = 0; c < nchunks; c++) {
+        uint64_t tokens = 0;
+        long lines = 0;
+        size_t pos = chunks[c].begin;
+        size_t len_tok;
+        size_t *marks = NULL, mark_capacity = 0;
+        while ((len_tok = next_token(buf, &pos, chunks[c].end)) > 0) {
+            if (tokens % TEXT_PARSE_MARK == 0) {
+                size_t k = (size_t)(tokens / TEXT_PARSE_MARK);
+                if (k == mark_capacity) {
+                    mark_capacity = mark_capacity ? mark_capacity * 2 : 64;
+                    marks = realloc(marks, mark_capacity * sizeof(size_t));
+                    if (!marks) {
+                        printf("Memory allocation failed.\n");
+                        exit(1);
+                    }
+                }
+                marks[k] = pos;
+            }
+            tokens++;
+            pos += len_tok;
+        }
+        chunks[c].marks = marks;
+        for (const char *p = buf + chunks[c].begin, *e = buf + chunks[c].end;
+             (p = memchr(p, '\n', (size_t)(e - p))) != NULL; p++) {
+            lines++;
+        }
+        chunks[c].tokens = tokens;
+        chunks[c].lines = lines;
+    }
+
+    uint64_t total = 0;
+    long line = 1;
+    for (int c = 0; c < nchunks; c++) {
+        chunks[c].first_token = total;
+        chunks[c].first_line = line;
+        total += chunks[c].tokens;
+        line += chunks[c].lines;
+    }
+
+    // Walk the block headers; each block's body is skipped by token count
+    ParseFailure fail = {.token = UINT64_MAX};
+    Block *blocks = NULL;
+    int nblocks = 0, block_capacity = 0;
+    Cursor cur = {.chunk = 0, .pos = chunks[0].begin, .index = 0};
+    uint64_t t = 0;
+    while (nblocks < max_matrices && t < total) {
+        size_t pos[3], tlen[3];
+        int have = 0;
+        for (; have < 3 && t + (uint64_t)have < total; have++) {
+            tlen[have] = token_at(buf, chunks, nchunks, &cur, t + (uint64_t)have, &pos[have]);
+        }
+        if (have < 3) {
+            record_failure(&fail, t, have > 0 ? pos[0] : len,
+                           "expected matrix name, rows and cols");
+            break;
+        }
+
+        char name[sizeof(((Matrix *)0)->name)];
+        int shown = tlen[0] < sizeof(name) - 1 ? (int)tlen[0] : (int)sizeof(name) - 1;
+        memcpy(name, buf + pos[0], (size_t)shown);
+        name[shown] = '\0';
+
+        int rows, cols;
+        if (parse_count(buf + pos[1], tlen[1], &rows) != 0) {
+            record_failure(&fail, t + 1, pos[1], "invalid row count '%.*s'",
+                           SHOWN(tlen[1]), buf + pos[1]);
+            break;
+        }
+        if (parse_count(buf + pos[2], tlen[2], &cols) != 0) {
+            record_failure(&fail, t + 2, pos[2], "invalid column count '%.*s'",
+                           SHOWN(tlen[2]), buf + pos[2]);
+            break;
+        }
+        uint64_t count = (uint64_t)rows * (uint64_t)cols;
+        if (count > total - (t + 3)) {
+            record_failure(&fail, t, pos[0], "matrix '%s' needs %llu values, file has %llu",
+                           name, (unsigned long long)count,
+                           (unsigned long long)(total - (t + 3)));
+            break;
+        }
+
+        if (nblocks == block_capacity) {
+            block_capacity = block_capacity ? block_capacity * 2 : 16;
+            blocks = realloc(blocks, (size_t)block_capacity * sizeof(Block));
+            if (!blocks) {
+                printf("Memory allocation failed.\n");
+                exit(1);
+            }
+        }
+        blocks[nblocks].m = create_matrix(rows, cols, name);
+        blocks[nblocks].first_value = t + 3;
+        blocks[nblocks].count = count;
+        nblocks++;
+        t += 3 + count;
+    }
+
+    // Each thread records its own earliest failure; the earliest overall wins
+    #pragma omp parallel
+    {
+        ParseFailure local = {.token = UINT64_MAX};
+        #pragma omp for schedule(static, 1)
+        for (int c = 0; c < nchunks; c++) {
+            parse_chunk(buf, &chunks[c], blocks, nblocks, &local);
+        }
+        if (local.token != UINT64_MAX) {
+            #pragma omp critical(text_parse_failure)
+            {
+                if (local.token < fail.token) fail = local;
+            }
+        }
+    }
+
+    int produced = 0;
+    Matrix **result = nblocks > 0 ? malloc((size_t)nblocks * sizeof(Matrix *)) : NULL;
+    if (nblocks > 0 && !result) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int b = 0; b < nblocks; b++) {
+        if (blocks[b].first_value + blocks[b].count <= fail.token)
+            result[produced++] = blocks[b].m;
+        else
+            free_matrix(blocks[b].m);
+    }
+    *out = result;
+
+    if (fail.token != UINT64_MAX) {
+        locate(buf, len, chunks, nchunks, fail.pos, err);
+        snprintf(err->message, sizeof(err->message), "%s", fail.message);
+    }
+
+    free(blocks);
+    for (int c = 0; c < nchunks; c++) free(chunks[c].marks);
+    free(chunks);
+    munmap((void *)buf, len);
+    return produced;
+}
+
+// ===== Writer =====
+int text_save_precision = TEXT_PRECISION_ROUND_TRIP;
+
+typedef struct {
+    char *data;
+    size_t used;
+    size_t cap;
+} TextBuffer;
+
+static char *text_buffer_reserve(TextBuffer *b, size_t extra) {
+    if (b->cap - b->used < extra) {
+        size_t cap = b->cap ? b->cap : TEXT_WRITE_BUFFER;
+        while (cap - b->used < extra) cap *= 2;
+        b->data = realloc(b->data, cap);
+        if (!b->data) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+        b->cap = cap;
+    }
+    return b->data + b->used;
+}
+
+// Integers below 2^53 are exact; print them without going through printf
+static int format_integer(char *out, double v) {
+    char tmp[24];
+    int n = 0;
+    int neg = v < 0 || (v == 0 && signbit(v));
+    uint64_t u = (uint64_t)(neg ? -v : v);
+    do {
+        tmp[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    int len = 0;
+    if (neg) out[len++] = '-';
+    while (n) out[len++] = tmp[--n];
+    return len;
+}
+
+// Lay out significant digits d[0..n) with value 0.d * 10^(point) the way %g
+// does: plain decimals for moderate exponents, d.ddde+XX otherwise
+static int emit_digits(char *out, int neg, const char *d, int n, int point) {
+    int len = 0;
+    if (neg) out[len++] = '-';
+    int x = point - 1;
+    if (x >= -5 && x < 17) {
+        if (point <= 0) {
+            out[len++] = '0';
+            out[len++] = '.';
+            for (int i = 0; i < -point; i++) out[len++] = '0';
+            for (int i = 0; i < n; i++) out[len++] = d[i];
+        } else {
+            for (int i = 0; i < point; i++) out[len++] = i < n ? d[i] : '0';
+            if (n > point) {
+                out[len++] = '.';
+                for (int i = point; i < n; i++) out[len++] = d[i];
+            }
+        }
+        return len;
+    }
+    out[len++] = d[0];
+    if (n > 1) {
+        out[len++] = '.';
+        for (int i = 1; i < n; i++) out[len++] = d[i];
+    }
+    return len + sprintf(out + len, "e%c%02d", x < 0 ? '-' : '+', x < 0 ? -x : x);
+}
+
+// ===== Shortest Round-Trip Digits (Grisu2) =====
+// Florian Loitsch's Grisu2: v and its rounding boundaries are scaled by a
+// cached power of ten into 64-bit fixed point and digits are generated until
+// they fall inside the boundary interval. The digits always read back to v
+// and are the shortest such string for all but a tiny fraction of inputs.
+typedef struct {
+    uint64_t f;
+    int e;
+} DiyFp;
+
+static const DiyFp cached_powers[87] = {
+    {0xfa8fd5a0081c0288ULL, -1220}, {0xbaaee17fa23ebf76ULL, -1193}, {0x8b16fb203055ac76ULL, -1166},
+    {0xcf42894a5dce35eaULL, -1140}, {0x9a6bb0aa55653b2dULL, -1113}, {0xe61acf033d1a45dfULL, -1087},
+    {0xab70fe17c79ac6caULL, -1060}, {0xff77b1fcbebcdc4fULL, -1034}, {0xbe5691ef416bd60cULL, -1007},
+    {0x8dd01fad907ffc3cULL, -980}, {0xd3515c2831559a83ULL, -954}, {0x9d71ac8fada6c9b5ULL, -927},
+    {0xea9c227723ee8bcbULL, -901}, {0xaecc49914078536dULL, -874}, {0x823c12795db6ce57ULL, -847},
+    {0xc21094364dfb5637ULL, -821}, {0x9096ea6f3848984fULL, -794}, {0xd77485cb25823ac7ULL, -768},
+    {0xa086cfcd97bf97f4ULL, -741}, {0xef340a98172aace5ULL, -715}, {0xb23867fb2a35b28eULL, -688},
+    {0x84c8d4dfd2c63f3bULL, -661}, {0xc5dd44271ad3cdbaULL, -635}, {0x936b9fcebb25c996ULL, -608},
+    {0xdbac6c247d62a584ULL, -582}, {0xa3ab66580d5fdaf6ULL, -555}, {0xf3e2f893dec3f126ULL, -529},
+    {0xb5b5ada8aaff80b8ULL, -502}, {0x87625f056c7c4a8bULL, -475}, {0xc9bcff6034c13053ULL, -449},
+    {0x964e858c91ba2655ULL, -422}, {0xdff9772470297ebdULL, -396}, {0xa6dfbd9fb8e5b88fULL, -369},
+    {0xf8a95fcf88747d94ULL, -343}, {0xb94470938fa89bcfULL, -316}, {0x8a08f0f8bf0f156bULL, -289},
+    {0xcdb02555653131b6ULL, -263}, {0x993fe2c6d07b7facULL, -236}, {0xe45c10c42a2b3b06ULL, -210},
+    {0xaa242499697392d3ULL, -183}, {0xfd87b5f28300ca0eULL, -157}, {0xbce5086492111aebULL, -130},
+    {0x8cbccc096f5088ccULL, -103}, {0xd1b71758e219652cULL, -77}, {0x9c40000000000000ULL, -50},
+    {0xe8d4a51000000000ULL, -24}, {0xad78ebc5ac620000ULL, 3}, {0x813f3978f8940984ULL, 30},
+    {0xc097ce7bc90715b3ULL, 56}, {0x8f7e32ce7bea5c70ULL, 83}, {0xd5d238a4abe98068ULL, 109},
+    {0x9f4f2726179a2245ULL, 136}, {0xed63a231d4c4fb27ULL, 162}, {0xb0de65388cc8ada8ULL, 189},
+    {0x83c7088e1aab65dbULL, 216}, {0xc45d1df942711d9aULL, 242}, {0x924d692ca61be758ULL, 269},
+    {0xda01ee641a708deaULL, 295}, {0xa26da3999aef774aULL, 322}, {0xf209787bb47d6b85ULL, 348},
+    {0xb454e4a179dd1877ULL, 375}, {0x865b86925b9bc5c2ULL, 402}, {0xc83553c5c8965d3dULL, 428},
+    {0x952ab45cfa97a0b3ULL, 455}, {0xde469fbd99a05fe3ULL, 481}, {0xa59bc234db398c25ULL, 508},
+    {0xf6c69a72a3989f5cULL, 534}, {0xb7dcbf5354e9beceULL, 561}, {0x88fcf317f22241e2ULL, 588},
+    {0xcc20ce9bd35c78a5ULL, 614}, {0x98165af37b2153dfULL, 641}, {0xe2a0b5dc971f303aULL, 667},
+    {0xa8d9d1535ce3b396ULL, 694}, {0xfb9b7cd9a4a7443cULL, 720}, {0xbb764c4ca7a44410ULL, 747},
+    {0x8bab8eefb6409c1aULL, 774}, {0xd01fef10a657842cULL, 800}, {0x9b10a4e5e9913129ULL, 827},
+    {0xe7109bfba19c0c9dULL, 853}, {0xac2820d9623bf429ULL, 880}, {0x80444b5e7aa7cf85ULL, 907},
+    {0xbf21e44003acdd2dULL, 933}, {0x8e679c2f5e44ff8fULL, 960}, {0xd433179d9c8cb841ULL, 986},
+    {0x9e19db92b4e31ba9ULL, 1013}, {0xeb96bf6ebadf77d9ULL, 1039}, {0xaf87023b9bf0ee6bULL, 1066},
+};
+
+static const uint64_t pow10_u64[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+    1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static DiyFp diyfp_mul(DiyFp x, DiyFp y) {
+    unsigned __int128 p = (unsigned __int128)x.f * y.f;
+    uint64_t h = (uint64_t)(p >> 64);
+    if ((uint64_t)p & (1ULL << 63)) h++;
+    return (DiyFp){h, x.e + y.e + 64};
+}
+
+static DiyFp diyfp_normalize(DiyFp x) {
+    int s = __builtin_clzll(x.f);
+    return (DiyFp){x.f << s, x.e - s};
+}
+
+static void grisu_round(char *buf, int len, uint64_t delta, uint64_t rest,
+                        uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int count_digits32(uint32_t n) {
+    int d = 1;
+    while (d < 10 && n >= pow10_u64[d]) d++;
+    return d;
+}
+
+// Digits of positive finite v into buf (at most 17); value = buf * 10^(*k)
+static int grisu2(double v, char *buf, int *k) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    int biased = (int)((bits >> 52) & 0x7FF);
+    uint64_t frac = bits & ((1ULL << 52) - 1);
+    DiyFp w = biased ? (DiyFp){frac | (1ULL << 52), biased - 1075}
+                     : (DiyFp){frac, -1074};
+
+    DiyFp plus = diyfp_normalize((DiyFp){(w.f << 1) + 1, w.e - 1});
+    DiyFp minus = (w.f == (1ULL << 52)) ? (DiyFp){(w.f << 2) - 1, w.e - 2}
+                                        : (DiyFp){(w.f << 1) - 1, w.e - 1};
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    double dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+    int ki = (int)dk;
+    if (dk - ki > 0.0) ki++;
+    int index = (ki >> 3) + 1;
+    *k = -(-348 + index * 8);
+    DiyFp c = cached_powers[index];
+
+    DiyFp W = diyfp_mul(diyfp_normalize(w), c);
+    DiyFp Wp = diyfp_mul(plus, c);
+    DiyFp Wm = diyfp_mul(minus, c);
+    Wm.f++;
+    Wp.f--;
+
+    uint64_t delta = Wp.f - Wm.f;
+    DiyFp one = {1ULL << -Wp.e, Wp.e};
+    uint64_t wp_w = Wp.f - W.f;
+    uint32_t p1 = (uint32_t)(Wp.f >> -one.e);
+    uint64_t p2 = Wp.f & (one.f - 1);
+    int kappa = count_digits32(p1);
+    int len = 0;
+
+    while (kappa > 0) {
+        uint32_t div = (uint32_t)pow10_u64[kappa - 1];
+        uint32_t d = p1 / div;
+        p1 %= div;
+        if (d || len) buf[len++] = (char)('0' + d);
+        kappa--;
+        uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buf, len, delta, rest, pow10_u64[kappa] << -one.e, wp_w);
+            return len;
+        }
+    }
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char)(p2 >> -one.e);
+        if (d || len) buf[len++] = (char)('0' + d);
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            int index10 = -kappa;
+            grisu_round(buf, len, delta, p2, one.f, index10 < 20 ? wp_w * pow10_u64[index10] : 0);
+            return len;
+        }
+    }
+}
+
+static int format_shortest(char *out, double v) {
+    if (v == floor(v) && fabs(v) < 9007199254740992.0)
+        return format_integer(out, v);
+    if (!isfinite(v))
+        return sprintf(out, "%g", v);
+
+    char digits[24];
+    int k;
+    int n = grisu2(fabs(v), digits, &k);
+    return emit_digits(out, signbit(v) != 0, digits, n, n + k);
+}
+
+static void format_rows(const Matrix *m, int r0, int r1, int precision, TextBuffer *b) {
+    // Worst case per value: "%.*f" of 1e308 with the requested decimals
+    size_t reserve = 330 + (size_t)(precision > 0 ? precision : 0);
+    for (int i = r0; i < r1; i++) {
+        const double *row = MATRIX_ROW(m, i);
+        for (int j = 0; j < m->cols; j++) {
+            char *dst = text_buffer_reserve(b, reserve);
+            int n = precision < 0 ? format_shortest(dst, row[j])
+                                  : snprintf(dst, reserve, "%.*f", precision, row[j]);
+            b->used += (size_t)n;
+            b->data[b->used++] = (j + 1 < m->cols) ? ' ' : '\n';
+        }
+    }
+}
+
+// Row blocks of about TEXT_WRITE_BLOCK_VALUES values are formatted by OpenMP
+// threads into private buffers and written strictly in row order.
+#define TEXT_WRITE_BLOCK_VALUES (1 << 15)
+
+int write_matrix_text_file(Matrix *m, const char *filename, int precision,
+                           char *err, size_t err_len) {
+    FILE *fp = fopen(filename, "w");
+    if (!fp) {
+        snprintf(err, err_len, "cannot open for writing: %s", strerror(errno));
+        return -1;
+    }
+    setvbuf(fp, NULL, _IONBF, 0);
+    if (precision > 100) precision = 100;
+
+    int ok = fprintf(fp, "%s %d %d\n", m->name, m->rows, m->cols) > 0;
+    int block = m->cols > 0 ? TEXT_WRITE_BLOCK_VALUES / m->cols : m->rows;
+    if (block < 1) block = 1;
+    int nblocks = m->rows > 0 ? (m->rows + block - 1) / block : 0;
+
+    #pragma omp parallel if(nblocks > 1)
+    {
+        TextBuffer b = {0};
+        #pragma omp for ordered schedule(static, 1)
+        for (int k = 0; k < nblocks; k++) {
+            int r0 = k * block;
+            int r1 = (r0 + block < m->rows) ? r0 + block : m->rows;
+            b.used = 0;
+            // Only the ordered section writes ok; the early check here is a
+            // hint that skips formatting after a failed write
+            int still_ok;
+            #pragma omp atomic read
+            still_ok = ok;
+            if (still_ok) format_rows(m, r0, r1, precision, &b);
+            #pragma omp ordered
+            {
+                if (ok && b.used > 0 && fwrite(b.data, 1, b.used, fp) != b.used) {
+                    #pragma omp atomic write
+                    ok = 0;
+                }
+            }
+        }
+        free(b.data);
+    }
+
+    if (fclose(fp) != 0) ok = 0;
+    if (!ok) {
+        snprintf(err, err_len, "write failed: %s", strerror(errno));
+        return -1;
+    }
+    return 0;
+}
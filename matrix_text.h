@@ -0,0 +1,46 @@
+#ifndef MATRIX_TEXT_H
+#define MATRIX_TEXT_H
+
+#include "matrix.h"
+
+// ===== Text Matrix Parser =====
+// A text file is a sequence of blocks `name rows cols v00 v01 ...`, tokens
+// separated by any whitespace. The file is mmap'd and cut into chunks on
+// line boundaries; OpenMP threads count the tokens in each chunk and note
+// the offset of every 256th, the block headers are located from the prefix
+// counts and those marks, then every thread parses its own chunk straight
+// into the matrices. Values are parsed with an exact
+// fast path for short decimals and strtod for everything else, so results
+// are correctly rounded.
+#define TEXT_PARSE_MIN_CHUNK (1 << 16)
+
+typedef struct {
+    long line;              // 1-based; 0 when there was no error
+    long col;               // 1-based byte column
+    char message[128];
+} TextParseError;
+
+// Parse up to max_matrices blocks (0 = all) into a malloc'd array stored in
+// *out. Returns how many matrices were produced, or -1 (with err->message
+// set) if the file could not be read. On a parse error err->line is set and
+// only the blocks that end before the error are returned. Never prints.
+int parse_matrix_text_file(const char *filename, Matrix ***out, int max_matrices,
+                           TextParseError *err);
+
+// ===== Text Matrix Writer =====
+// Writes one `name rows cols` block, one matrix row per line. Rows are
+// formatted in parallel into buffers of at least TEXT_WRITE_BUFFER bytes and
+// written in order. With TEXT_PRECISION_ROUND_TRIP each value gets a short
+// digit string that reads back to the same double, e.g. 28.306: Grisu2
+// output, which is the shortest possible for all but a few values in ten
+// thousand. A precision >= 0 writes that many fixed decimals, like the old
+// "%.2lf".
+// Returns 0, or -1 with a message in err; never prints.
+#define TEXT_WRITE_BUFFER (1 << 20)
+#define TEXT_PRECISION_ROUND_TRIP (-1)
+extern int text_save_precision;
+
+int write_matrix_text_file(Matrix *m, const char *filename, int precision,
+                           char *err, size_t err_len);
+
+#endif
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "registry.h"
+
+// ===== Storage =====
+#define REGISTRY_INITIAL_SLOTS 64
+#define INDEX_EMPTY (-1)
+#define INDEX_TOMBSTONE (-2)
+
+typedef struct {
+    Matrix *m;              // NULL while the slot is free
+    uint32_t generation;
+    int prev;               // insertion-order chain, -1 at the ends
+    int next;               // doubles as the free-list link for free slots
+} Slot;
+
+static Slot *slots = NULL;
+static int slot_capacity = 0;
+static int free_head = -1;
+static int head = -1;
+static int tail = -1;
+static int live = 0;
+
+// Open addressing with linear probing; entries are slot indices
+static int *index_table = NULL;
+static int index_capacity = 0;      // power of two
+static int index_used = 0;          // live entries plus tombstones
+
+static void *checked_realloc(void *p, size_t bytes) {
+    p = realloc(p, bytes);
+    if (!p) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    return p;
+}
+
+static uint64_t hash_name(const char *name) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        h ^= *p;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static MatrixHandle make_handle(int slot) {
+    return ((uint64_t)slots[slot].generation << 32) | (uint64_t)(slot + 1);
+}
+
+// Slot index for a live handle, or -1
+static int handle_slot(MatrixHandle h) {
+    int slot = (int)(h & 0xffffffffu) - 1;
+    if (slot < 0 || slot >= slot_capacity) return -1;
+    if (!slots[slot].m || slots[slot].generation != (uint32_t)(h >> 32)) return -1;
+    return slot;
+}
+
+// ===== Name Index =====
+// Position holding `name`, or -1
+static int index_lookup(const char *name) {
+    if (index_capacity == 0) return -1;
+    size_t mask = (size_t)index_capacity - 1;
+    for (size_t i = hash_name(name) & mask;; i = (i + 1) & mask) {
+        int s = index_table[i];
+        if (s == INDEX_EMPTY) return -1;
+        if (s >= 0 && strcmp(slots[s].m->name, name) == 0) return (int)i;
+    }
+}
+
+static void index_place(int slot) {
+    size_t mask = (size_t)index_capacity - 1;
+    size_t i = hash_name(slots[slot].m->name) & mask;
+    while (index_table[i] >= 0) i = (i + 1) & mask;
+    if (index_table[i] == INDEX_EMPTY) index_used++;
+    index_table[i] = slot;
+}
+
+// Keep the table at most half full, counting tombstones; rebuilding drops them
+static void index_reserve(void) {
+    if ((index_used + 1) * 2 <= index_capacity) return;
+    int capacity = index_capacity ? index_capacity : REGISTRY_INITIAL_SLOTS;
+    while ((live + 1) * 2 > capacity / 2) capacity *= 2;
+    free(index_table);
+    index_table = checked_realloc(NULL, (size_t)capacity * sizeof(int));
+    for (int i = 0; i < capacity; i++) index_table[i] = INDEX_EMPTY;
+    index_capacity = capacity;
+    index_used = 0;
+    for (int s = head; s != -1; s = slots[s].next) index_place(s);
+}
+
+// ===== Public API =====
+MatrixHandle registry_add(Matrix *m) {
+    if (!m) return MATRIX_HANDLE_NONE;
+
+    if (index_lookup(m->name) != -1) {
+        char base[sizeof(m->name)];
+        snprintf(base, sizeof(base), "%s", m->name);
+        for (int n = 2; index_lookup(m->name) != -1; n++) {
+            char suffix[16];
+            int len = snprintf(suffix, sizeof(suffix), "_%d", n);
+            int keep = (int)strlen(base);
+            if (keep > (int)sizeof(m->name) - 1 - len) keep = (int)sizeof(m->name) - 1 - len;
+            snprintf(m->name, sizeof(m->name), "%.*s%s", keep, base, suffix);
+        }
+    }
+
+    index_reserve();
+
+    if (free_head == -1) {
+        int capacity = slot_capacity ? slot_capacity * 2 : REGISTRY_INITIAL_SLOTS;
+        slots = checked_realloc(slots, (size_t)capacity * sizeof(Slot));
+        for (int s = capacity - 1; s >= slot_capacity; s--) {
+            slots[s] = (Slot){.m = NULL, .generation = 1, .prev = -1, .next = free_head};
+            free_head = s;
+        }
+        slot_capacity = capacity;
+    }
+
+    int s = free_head;
+    free_head = slots[s].next;
+    slots[s].m = m;
+    slots[s].prev = tail;
+    slots[s].next = -1;
+    if (tail != -1) slots[tail].next = s;
+    else head = s;
+    tail = s;
+    live++;
+
+    index_place(s);
+    return make_handle(s);
+}
+
+int registry_remove(MatrixHandle h) {
+    int s = handle_slot(h);
+    if (s == -1) return -1;
+
+    index_table[index_lookup(slots[s].m->name)] = INDEX_TOMBSTONE;
+
+    if (slots[s].prev != -1) slots[slots[s].prev].next = slots[s].next;
+    else head = slots[s].next;
+    if (slots[s].next != -1) slots[slots[s].next].prev = slots[s].prev;
+    else tail = slots[s].prev;
+
+    free_matrix(slots[s].m);
+    slots[s].m = NULL;
+    slots[s].generation++;
+    slots[s].next = free_head;
+    free_head = s;
+    live--;
+    return 0;
+}
+
+Matrix *registry_get(MatrixHandle h) {
+    int s = handle_slot(h);
+    return s == -1 ? NULL : slots[s].m;
+}
+
+MatrixHandle registry_find(const char *name) {
+    int i = index_lookup(name);
+    return i == -1 ? MATRIX_HANDLE_NONE : make_handle(index_table[i]);
+}
+
+int registry_count(void) {
+    return live;
+}
+
+void registry_clear(void) {
+    while (head != -1) registry_remove(make_handle(head));
+}
+
+MatrixHandle registry_first(void) {
+    return head == -1 ? MATRIX_HANDLE_NONE : make_handle(head);
+}
+
+MatrixHandle registry_next(MatrixHandle h) {
+    int s = handle_slot(h);
+    if (s == -1 || slots[s].next == -1) return MATRIX_HANDLE_NONE;
+    return make_handle(slots[s].next);
+}
+
+MatrixHandle registry_nth(int position) {
+    if (position < 1 || position > live) return MATRIX_HANDLE_NONE;
+    int s = head;
+    while (--position > 0) s = slots[s].next;
+    return make_handle(s);
+}
@@ -0,0 +1,33 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <stdint.h>
+#include "matrix.h"
+
+// ===== Matrix Registry =====
+// Owns every workspace matrix. Entries sit in a slot array that grows by
+// doubling and are chained in insertion order, so add and remove are O(1)
+// and listings keep a stable order. A handle packs the slot index with the
+// slot's generation: it stays valid until its matrix is removed and never
+// refers to a later occupant of the same slot. Names are indexed by an
+// open-addressing hash table, and every name is unique.
+typedef uint64_t MatrixHandle;
+#define MATRIX_HANDLE_NONE ((MatrixHandle)0)
+
+// Takes ownership of m. A name already in use gets a "_2", "_3", ... suffix.
+MatrixHandle registry_add(Matrix *m);
+// Frees the matrix; returns -1 if the handle is stale
+int registry_remove(MatrixHandle h);
+// NULL for a stale handle
+Matrix *registry_get(MatrixHandle h);
+MatrixHandle registry_find(const char *name);
+int registry_count(void);
+void registry_clear(void);
+
+// Insertion-order iteration; both return MATRIX_HANDLE_NONE at the end
+MatrixHandle registry_first(void);
+MatrixHandle registry_next(MatrixHandle h);
+// 1-based position in listing order, for numbered menus; O(n)
+MatrixHandle registry_nth(int position);
+
+#endif
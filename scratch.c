@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "matrix.h"
+#include "scratch.h"
+
+// ===== Blocks =====
+// Each thread keeps a chain of blocks. Blocks up to `current` hold live
+// buffers; the ones after it are spare and get reused before anything new is
+// allocated. A NULL current means nothing is allocated.
+typedef struct ScratchBlock {
+    struct ScratchBlock *next;
+    size_t size;
+    size_t used;
+} ScratchBlock;
+
+#define SCRATCH_HEADER \
+    ((sizeof(ScratchBlock) + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT)
+
+static _Thread_local ScratchBlock *first = NULL;
+static _Thread_local ScratchBlock *current = NULL;
+
+// Blocks are mapped directly so a freed one goes back to the kernel instead
+// of lingering in a malloc arena
+static ScratchBlock *new_block(size_t size, ScratchBlock *next) {
+    ScratchBlock *b = mmap(NULL, SCRATCH_HEADER + size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (b == MAP_FAILED) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    b->next = next;
+    b->size = size;
+    b->used = 0;
+    return b;
+}
+
+// ===== Public API =====
+ScratchMark scratch_mark(void) {
+    return (ScratchMark){current, current ? current->used : 0};
+}
+
+void *scratch_alloc(size_t bytes) {
+    bytes = (bytes + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+    if (bytes == 0) bytes = MATRIX_ALIGNMENT;
+
+    if (!current || current->size - current->used < bytes) {
+        ScratchBlock *spare = current ? current->next : first;
+        if (!spare || spare->size < bytes) {
+            // Too small spares stay further down the chain
+            size_t size = bytes > SCRATCH_BLOCK_BYTES ? bytes : SCRATCH_BLOCK_BYTES;
+            spare = new_block(size, spare);
+            if (current) current->next = spare;
+            else first = spare;
+        }
+        current = spare;
+        current->used = 0;
+    }
+
+    void *p = (char *)current + SCRATCH_HEADER + current->used;
+    current->used += bytes;
+    return p;
+}
+
+void scratch_release(ScratchMark mark) {
+    current = mark.block;
+    if (current) current->used = mark.used;
+
+    // Spares beyond SCRATCH_SPARE_BYTES are unmapped, so a one-off
+    // large request does not stay resident for the life of the thread
+    size_t budget = SCRATCH_SPARE_BYTES;
+    ScratchBlock **link = current ? &current->next : &first;
+    while (*link) {
+        ScratchBlock *b = *link;
+        if (b->size <= budget) {
+            budget -= b->size;
+            link = &b->next;
+        } else {
+            *link = b->next;
+            munmap(b, SCRATCH_HEADER + b->size);
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <stddef.h>
+
+// ===== Scratch Arena =====
+// Per-thread bump allocator for kernel temporaries. A kernel takes a mark,
+// carves buffers with scratch_alloc and hands them all back at once with
+// scratch_release; marks nest, so the last mark taken is released first.
+// Released blocks up to SCRATCH_SPARE_BYTES per thread are kept for reuse,
+// so a warm thread allocates its usual temporaries (gemm panels, solver
+// vectors) without a system call; larger spares are unmapped on release.
+// Buffers are MATRIX_ALIGNMENT aligned and uninitialised, and belong to the
+// thread that allocated them until released, though other threads may read
+// and write them meanwhile.
+#define SCRATCH_BLOCK_BYTES (1 << 20)
+#define SCRATCH_SPARE_BYTES (8 << 20)
+
+typedef struct {
+    void *block;
+    size_t used;
+} ScratchMark;
+
+ScratchMark scratch_mark(void);
+// Never returns NULL; exits if memory runs out, like create_matrix
+void *scratch_alloc(size_t bytes);
+void scratch_release(ScratchMark mark);
+
+#endif
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,8 +13,14 @@
 #include <omp.h>
 #include "worker_pool.h"
 #include "matrix.h"
+#include "gemm.h"
+#include "lu.h"
+#include "scratch.h"
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
 
 // ===== Global Variables =====
 Worker *worker_pool = NULL;
@@ -22,7 +29,17 @@ int pool_size = 0;
 static int status_fifo_fd = -1;
 static pid_t monitor_pid = -1;
 int max_idle_time = 60;
+int fork_children = 0;
 volatile sig_atomic_t workers_completed = 0;
+static uint32_t next_request_id = 1;
+
+#define ARENA_INITIAL_SIZE (1 << 20)
+static int arena_fd = -1;
+static char *arena_base = NULL;
+static size_t arena_mapped = 0;
+static size_t arena_size = 0;
+static size_t arena_used = 0;
+static int pool_epoll_fd = -1;
 
 // ===== Signal Handlers =====
 void sigusr1_handler(int signo) {
@@ -61,57 +78,342 @@ double get_time_ms(void) {
     return (tv.tv_sec * 1000.0) + (tv.tv_usec / 1000.0);
 }
 
+// ===== Framed IPC =====
+static int read_full(int fd, void *buf, size_t len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int writev_full(int fd, struct iovec *iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t n = writev(fd, iov, iovcnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        // Skip the fully written vectors and trim the partially written one
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return 0;
+}
+
+int send_frame(int fd, uint32_t opcode, uint32_t request_id,
+               const struct iovec *payload, int iovcnt) {
+    struct iovec iov[FRAME_MAX_IOV + 1];
+    if (iovcnt > FRAME_MAX_IOV) return -1;
+
+    FrameHeader hdr = {.opcode = opcode, .request_id = request_id, .payload_len = 0};
+    for (int i = 0; i < iovcnt; i++) {
+        hdr.payload_len += payload[i].iov_len;
+        iov[i + 1] = payload[i];
+    }
+    iov[0].iov_base = &hdr;
+    iov[0].iov_len = sizeof(hdr);
+
+    return writev_full(fd, iov, iovcnt + 1);
+}
+
+int recv_frame(int fd, FrameHeader *hdr, void **payload, size_t *capacity) {
+    if (read_full(fd, hdr, sizeof(*hdr)) == -1) return -1;
+
+    if (hdr->payload_len > *capacity) {
+        void *grown = realloc(*payload, hdr->payload_len);
+        if (!grown) return -1;
+        *payload = grown;
+        *capacity = hdr->payload_len;
+    }
+    if (hdr->payload_len > 0 && read_full(fd, *payload, hdr->payload_len) == -1) {
+        return -1;
+    }
+    return 0;
+}
+
+// ===== Shared Operand Arena =====
+// Created before the workers are forked, so every worker inherits both the
+// memfd and the mapping. Growth is ftruncate on the parent side; a worker
+// remaps lazily when a job names a larger arena than it has mapped.
+static int ensure_arena_mapped(size_t size) {
+    if (size <= arena_mapped) return 0;
+
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, arena_fd, 0);
+    if (base == MAP_FAILED) return -1;
+    if (arena_base) munmap(arena_base, arena_mapped);
+    arena_base = base;
+    arena_mapped = size;
+    return 0;
+}
+
+static void init_arena(size_t size) {
+    arena_fd = memfd_create("matrix_pool_arena", MFD_CLOEXEC);
+    if (arena_fd == -1 || ftruncate(arena_fd, (off_t)size) == -1 ||
+        ensure_arena_mapped(size) == -1) {
+        perror("[ARENA] shared mapping failed");
+        exit(1);
+    }
+    arena_size = size;
+    arena_used = 0;
+}
+
+static void destroy_arena(void) {
+    if (arena_base) munmap(arena_base, arena_mapped);
+    if (arena_fd != -1) close(arena_fd);
+    arena_base = NULL;
+    arena_mapped = arena_size = arena_used = 0;
+    arena_fd = -1;
+}
+
+uint64_t pool_arena_alloc(size_t bytes) {
+    size_t off = (arena_used + MATRIX_ALIGNMENT - 1) & ~(size_t)(MATRIX_ALIGNMENT - 1);
+    size_t needed = off + bytes;
+
+    if (needed > arena_size) {
+        size_t grown = arena_size * 2;
+        while (grown < needed) grown *= 2;
+        if (ftruncate(arena_fd, (off_t)grown) == -1 || ensure_arena_mapped(grown) == -1) {
+            perror("[ARENA] grow failed");
+            exit(1);
+        }
+        arena_size = grown;
+    }
+    arena_used = needed;
+    return off;
+}
+
+void *pool_arena_ptr(uint64_t offset) {
+    return arena_base + offset;
+}
+
+void pool_arena_reset(void) {
+    arena_used = 0;
+}
+
+uint64_t pool_arena_put_matrix(Matrix *m) {
+    size_t bytes = (size_t)m->rows * m->stride * sizeof(double);
+    uint64_t off = pool_arena_alloc(bytes);
+    memcpy(pool_arena_ptr(off), m->storage, bytes);
+    return off;
+}
+
+void pool_arena_get_matrix(uint64_t offset, Matrix *m) {
+    memcpy(m->storage, pool_arena_ptr(offset),
+           (size_t)m->rows * m->stride * sizeof(double));
+}
+
+static int region_fits(uint64_t off, int rows, int cols, int stride, uint64_t limit) {
+    if (rows < 0 || cols < 0 || stride < cols) return 0;
+    if (rows == 0 || cols == 0) return off <= limit;
+    uint64_t extent = ((uint64_t)(rows - 1) * stride + cols) * sizeof(double);
+    return off % sizeof(double) == 0 && off <= limit && extent <= limit - off;
+}
+
+// Bounds-check a job against the arena it was built for; 0 means reject
+static int validate_shm_job(uint32_t opcode, const ShmJob *job) {
+    uint64_t limit = job->arena_size;
+    switch (opcode) {
+        case OP_ADD:
+        case OP_SUBTRACT:
+            return region_fits(job->a_off, job->rows, job->cols, job->a_stride, limit) &&
+                   region_fits(job->b_off, job->rows, job->cols, job->b_stride, limit) &&
+                   region_fits(job->c_off, job->rows, job->cols, job->c_stride, limit);
+        case OP_GEMM_PANEL:
+        case OP_LU_UPDATE:
+            return region_fits(job->a_off, job->rows, job->inner, job->a_stride, limit) &&
+                   region_fits(job->b_off, job->inner, job->cols, job->b_stride, limit) &&
+                   region_fits(job->c_off, job->rows, job->cols, job->c_stride, limit);
+        case OP_MATRIX_VECTOR_MULTIPLY:
+            return region_fits(job->a_off, job->rows, job->inner, job->a_stride, limit) &&
+                   region_fits(job->b_off, 1, job->inner, job->inner, limit) &&
+                   region_fits(job->c_off, job->rows, 1, job->c_stride, limit);
+        case OP_PARTITION_LOAD:
+            return region_fits(job->a_off, job->rows, job->inner, job->a_stride, limit);
+        case OP_PARTITION_MATVEC:
+            return region_fits(job->b_off, 1, job->inner, job->inner, limit) &&
+                   region_fits(job->c_off, job->rows, 1, job->c_stride, limit);
+        default:
+            return 0;
+    }
+}
+
+static void run_shm_job(uint32_t opcode, const ShmJob *job) {
+    const char *base = arena_base;
+    const double *a = (const double *)(base + job->a_off);
+    const double *b = (const double *)(base + job->b_off);
+    double *c = (double *)(arena_base + job->c_off);
+
+    switch (opcode) {
+        case OP_ADD:
+        case OP_SUBTRACT:
+            for (int i = 0; i < job->rows; i++) {
+                const double *ar = a + (size_t)i * job->a_stride;
+                const double *br = b + (size_t)i * job->b_stride;
+                double *cr = c + (size_t)i * job->c_stride;
+                if (opcode == OP_ADD) {
+                    for (int j = 0; j < job->cols; j++) cr[j] = ar[j] + br[j];
+                } else {
+                    for (int j = 0; j < job->cols; j++) cr[j] = ar[j] - br[j];
+                }
+            }
+            break;
+
+        case OP_GEMM_PANEL:
+            gemm(job->rows, job->cols, job->inner, 1.0, a, job->a_stride,
+                 b, job->b_stride, 0.0, c, job->c_stride);
+            break;
+
+        case OP_LU_UPDATE:
+            gemm(job->rows, job->cols, job->inner, -1.0, a, job->a_stride,
+                 b, job->b_stride, 1.0, c, job->c_stride);
+            break;
+
+        case OP_MATRIX_VECTOR_MULTIPLY:
+            for (int i = 0; i < job->rows; i++) {
+                const double *ar = a + (size_t)i * job->a_stride;
+                double sum = 0.0;
+                for (int k = 0; k < job->inner; k++) sum += ar[k] * b[k];
+                c[(size_t)i * job->c_stride] = sum;
+            }
+            break;
+    }
+}
+
+// ===== Resident Partition =====
+// Rows a worker keeps across requests so iterative solvers only ship the
+// vector each step. Private to the worker process.
+typedef struct {
+    double *data;
+    int rows;
+    int cols;
+    int stride;
+} Partition;
+
+static int partition_load(Partition *p, const ShmJob *job) {
+    free(p->data);
+    p->data = NULL;
+    p->rows = p->cols = p->stride = 0;
+
+    int stride = matrix_stride_for(job->inner);
+    size_t bytes = (size_t)job->rows * stride * sizeof(double);
+    if (bytes > 0 && posix_memalign((void **)&p->data, MATRIX_ALIGNMENT, bytes) != 0) {
+        p->data = NULL;
+        return -1;
+    }
+    const double *a = (const double *)(arena_base + job->a_off);
+    for (int i = 0; i < job->rows; i++) {
+        memcpy(p->data + (size_t)i * stride, a + (size_t)i * job->a_stride,
+               (size_t)job->inner * sizeof(double));
+    }
+    p->rows = job->rows;
+    p->cols = job->inner;
+    p->stride = stride;
+    return 0;
+}
+
+static int partition_matvec(const Partition *p, const ShmJob *job) {
+    if (job->rows != p->rows || job->inner != p->cols) return -1;
+    const double *b = (const double *)(arena_base + job->b_off);
+    double *c = (double *)(arena_base + job->c_off);
+    for (int i = 0; i < p->rows; i++) {
+        const double *ar = p->data + (size_t)i * p->stride;
+        double sum = 0.0;
+        for (int k = 0; k < p->cols; k++) sum += ar[k] * b[k];
+        c[(size_t)i * job->c_stride] = sum;
+    }
+    return 0;
+}
+
 // ===== Worker Process Loop =====
 void worker_process_loop(int input_fd, int output_fd) {
-    WorkMessage msg;
+    FrameHeader hdr;
+    void *payload = NULL;
+    size_t payload_cap = 0;
+    Partition partition = {0};
     
-    while (1) {
-        ssize_t n = read(input_fd, &msg, sizeof(WorkMessage));
-        if (n <= 0) break;
+    while (recv_frame(input_fd, &hdr, &payload, &payload_cap) == 0) {
+        if (hdr.opcode == OP_EXIT) break;
+
+        double value = 0.0;
+        struct iovec out = {.iov_base = &value, .iov_len = 0};
+        int valid = 0;
         
-        switch (msg.op_type) {
+        switch (hdr.opcode) {
             case OP_ADD:
-                msg.result = msg.operand1 + msg.operand2;
-                break;
-                
             case OP_SUBTRACT:
-                msg.result = msg.operand1 - msg.operand2;
+            case OP_GEMM_PANEL:
+            case OP_LU_UPDATE:
+            case OP_MATRIX_VECTOR_MULTIPLY: {
+                ShmJob job;
+                if (hdr.payload_len != sizeof(job)) break;
+                memcpy(&job, payload, sizeof(job));
+                if (!validate_shm_job(hdr.opcode, &job) ||
+                    ensure_arena_mapped(job.arena_size) == -1) {
+                    break;
+                }
+                run_shm_job(hdr.opcode, &job);
+                valid = 1;
                 break;
-                
-            case OP_MULTIPLY_ELEMENT:
-                msg.result = 0.0;
-                for (int i = 0; i < msg.row_size; i++) {
-                    msg.result += msg.row_data[i] * msg.col_data[i];
+            }
+            
+            case OP_PARTITION_LOAD:
+            case OP_PARTITION_MATVEC: {
+                ShmJob job;
+                if (hdr.payload_len != sizeof(job)) break;
+                memcpy(&job, payload, sizeof(job));
+                if (!validate_shm_job(hdr.opcode, &job) ||
+                    ensure_arena_mapped(job.arena_size) == -1) {
+                    break;
                 }
+                valid = (hdr.opcode == OP_PARTITION_LOAD)
+                            ? partition_load(&partition, &job) == 0
+                            : partition_matvec(&partition, &job) == 0;
                 break;
-                
-            case OP_DETERMINANT_2X2:
-                msg.result = msg.matrix_data[0][0] * msg.matrix_data[1][1] - 
-                            msg.matrix_data[0][1] * msg.matrix_data[1][0];
+            }
+            
+            case OP_PARTITION_RELEASE:
+                free(partition.data);
+                partition = (Partition){0};
+                valid = 1;
                 break;
                 
-            case OP_MATRIX_VECTOR_MULTIPLY:
-                for (int i = 0; i < msg.matrix_size; i++) {
-                    msg.row_data[i] = 0.0;
-                    for (int j = 0; j < msg.matrix_size; j++) {
-                        msg.row_data[i] += msg.matrix_data[i][j] * msg.vector_data[j];
-                    }
-                }
+            case OP_DETERMINANT_2X2: {
+                double m[4];
+                if (hdr.payload_len != sizeof(m)) break;
+                memcpy(m, payload, sizeof(m));
+                value = m[0] * m[3] - m[1] * m[2];
+                out.iov_len = sizeof(value);
+                valid = 1;
                 break;
-                
-            case OP_EXIT:
-                close(input_fd);
-                close(output_fd);
-                exit(0);
+            }
                 
             default:
-                msg.result = 0.0;
+                break;
         }
-        
-        write(output_fd, &msg, sizeof(WorkMessage));
+
+        int sent = valid ? send_frame(output_fd, hdr.opcode, hdr.request_id, &out, 1)
+                         : send_frame(output_fd, OP_ERROR, hdr.request_id, NULL, 0);
+        if (sent == -1) break;
         kill(getppid(), SIGUSR1);
     }
     
+    free(payload);
+    free(partition.data);
     close(input_fd);
     close(output_fd);
     exit(0);
@@ -201,6 +503,20 @@ void monitor_status_fifo_background(void) {
 }
 
 // ===== Worker Pool Management =====
+static void retire_worker(Worker *w) {
+    epoll_ctl(pool_epoll_fd, EPOLL_CTL_DEL, w->output_pipe[0], NULL);
+    w->alive = 0;
+    w->in_flight = 0;
+}
+
+// The epoll set is level-triggered, so a worker that is readable while it
+// owes nothing (it hung up, or sent a stray frame) must be read now or
+// epoll_wait keeps reporting it: drop the frame, or retire it on EOF.
+static void drain_idle_worker(Worker *w, void **payload, size_t *capacity) {
+    FrameHeader hdr;
+    if (recv_frame(w->output_pipe[0], &hdr, payload, capacity) == -1) retire_worker(w);
+}
+
 void init_worker_pool(int size) {
     pool_size = size;
     worker_pool = malloc(size * sizeof(Worker));
@@ -209,6 +525,7 @@ void init_worker_pool(int size) {
     
     init_status_fifo();
     monitor_status_fifo_background();
+    init_arena(ARENA_INITIAL_SIZE);
     
     for (int i = 0; i < size; i++) {
         if (pipe(worker_pool[i].input_pipe) == -1 ||
@@ -237,9 +554,24 @@ void init_worker_pool(int size) {
         worker_pool[i].pid = pid;
         worker_pool[i].available = 1;
         worker_pool[i].alive = 1;
+        worker_pool[i].in_flight = 0;
         worker_pool[i].last_used = time(NULL);
     }
     
+    // One epoll set over every worker's reply pipe, tagged with its index
+    pool_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (pool_epoll_fd == -1) {
+        perror("epoll_create1");
+        exit(1);
+    }
+    for (int i = 0; i < size; i++) {
+        struct epoll_event ev = {.events = EPOLLIN, .data.u32 = (uint32_t)i};
+        if (epoll_ctl(pool_epoll_fd, EPOLL_CTL_ADD, worker_pool[i].output_pipe[0], &ev) == -1) {
+            perror("epoll_ctl");
+            exit(1);
+        }
+    }
+    
     printf("[INFO] Worker pool initialized successfully\n");
     send_status_via_fifo("POOL_READY");
 }
@@ -267,9 +599,8 @@ void age_workers(void) {
     for (int i = 0; i < pool_size; i++) {
         if (worker_pool[i].alive && worker_pool[i].available) {
             if (now - worker_pool[i].last_used > max_idle_time) {
-                WorkMessage msg = {.op_type = OP_EXIT};
-                write(worker_pool[i].input_pipe[1], &msg, sizeof(WorkMessage));
-                worker_pool[i].alive = 0;
+                send_frame(worker_pool[i].input_pipe[1], OP_EXIT, 0, NULL, 0);
+                retire_worker(&worker_pool[i]);
                 printf("[INFO] Aged out worker %d (idle for %ld seconds)\n",
                        i, (long)(now - worker_pool[i].last_used));
             }
@@ -285,8 +616,7 @@ void cleanup_worker_pool(void) {
     
     for (int i = 0; i < pool_size; i++) {
         if (worker_pool[i].alive) {
-            WorkMessage msg = {.op_type = OP_EXIT};
-            write(worker_pool[i].input_pipe[1], &msg, sizeof(WorkMessage));
+            send_frame(worker_pool[i].input_pipe[1], OP_EXIT, 0, NULL, 0);
             close(worker_pool[i].input_pipe[1]);
             close(worker_pool[i].output_pipe[0]);
             waitpid(worker_pool[i].pid, NULL, 0);
@@ -298,6 +628,9 @@ void cleanup_worker_pool(void) {
         waitpid(monitor_pid, NULL, 0);
     }
     cleanup_status_fifo();
+    destroy_arena();
+    close(pool_epoll_fd);
+    pool_epoll_fd = -1;
     
     free(worker_pool);
     worker_pool = NULL;
@@ -305,6 +638,136 @@ void cleanup_worker_pool(void) {
 }
 
 // ===== WORKER POOL OPERATIONS =====
+// Queue one tile on a worker; returns the owning worker index, or -1 when
+// the send failed and the tile was computed in the parent instead
+static int send_tile(Worker *w, uint32_t opcode, uint32_t id, ShmJob *tile, int *in_flight_total) {
+    struct iovec iov = {.iov_base = tile, .iov_len = sizeof(*tile)};
+    if (send_frame(w->input_pipe[1], opcode, id, &iov, 1) == 0) {
+        w->in_flight++;
+        (*in_flight_total)++;
+        return (int)(w - worker_pool);
+    }
+    run_shm_job(opcode, tile);
+    return -1;
+}
+
+// Split a job into row tiles, several per worker, and keep up to
+// POOL_MAX_IN_FLIGHT of them queued on each worker's pipe. Completions are
+// multiplexed with epoll and matched by request id, so they may arrive in
+// any order; each completion immediately tops its worker back up. Tiles that
+// fail or cannot be sent are computed in the parent from the same arena.
+static void dispatch_row_blocks(uint32_t opcode, const ShmJob *job) {
+    Worker *workers[MAX_WORKERS];
+    int nworkers = 0;
+    Worker *w;
+    while (nworkers < MAX_WORKERS && nworkers < job->rows &&
+           (w = get_available_worker()) != NULL) {
+        w->in_flight = 0;
+        workers[nworkers++] = w;
+    }
+    if (nworkers == 0) {
+        run_shm_job(opcode, job);
+        return;
+    }
+
+    int ntiles = nworkers * POOL_TILES_PER_WORKER;
+    if (ntiles > job->rows) ntiles = job->rows;
+    int chunk = (job->rows + ntiles - 1) / ntiles;
+    ntiles = (job->rows + chunk - 1) / chunk;
+
+    // Element-wise operands advance with the output; product operands do not
+    int b_moves = (opcode == OP_ADD || opcode == OP_SUBTRACT);
+    ScratchMark mark = scratch_mark();
+    ShmJob *tiles = scratch_alloc(ntiles * sizeof(ShmJob));
+    int *owner = scratch_alloc(ntiles * sizeof(int));
+    for (int t = 0; t < ntiles; t++) {
+        int r0 = t * chunk;
+        tiles[t] = *job;
+        tiles[t].rows = (job->rows - r0 < chunk) ? job->rows - r0 : chunk;
+        tiles[t].a_off += (uint64_t)r0 * job->a_stride * sizeof(double);
+        tiles[t].c_off += (uint64_t)r0 * job->c_stride * sizeof(double);
+        if (b_moves) tiles[t].b_off += (uint64_t)r0 * job->b_stride * sizeof(double);
+        tiles[t].arena_size = arena_size;
+        owner[t] = -1;
+    }
+
+    uint32_t base_id = next_request_id;
+    next_request_id += (uint32_t)ntiles;
+    int next_tile = 0;
+    int in_flight = 0;
+
+    for (int depth = 0; depth < POOL_MAX_IN_FLIGHT; depth++) {
+        for (int k = 0; k < nworkers && next_tile < ntiles; k++) {
+            owner[next_tile] = send_tile(workers[k], opcode, base_id + next_tile,
+                                         &tiles[next_tile], &in_flight);
+            next_tile++;
+        }
+    }
+
+    void *reply = NULL;
+    size_t reply_cap = 0;
+    struct epoll_event events[MAX_WORKERS];
+
+    while (in_flight > 0) {
+        int nev = epoll_wait(pool_epoll_fd, events, MAX_WORKERS, -1);
+        if (nev < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int e = 0; e < nev; e++) {
+            int idx = (int)events[e].data.u32;
+            w = &worker_pool[idx];
+            if (w->in_flight == 0) {
+                drain_idle_worker(w, &reply, &reply_cap);
+                continue;
+            }
+
+            FrameHeader hdr;
+            if (recv_frame(w->output_pipe[0], &hdr, &reply, &reply_cap) == -1) {
+                // Worker is gone: recompute whatever it still owed us
+                for (int t = 0; t < ntiles; t++) {
+                    if (owner[t] == idx) {
+                        run_shm_job(opcode, &tiles[t]);
+                        owner[t] = -1;
+                    }
+                }
+                in_flight -= w->in_flight;
+                retire_worker(w);
+                continue;
+            }
+
+            uint32_t t = hdr.request_id - base_id;
+            if (t >= (uint32_t)ntiles || owner[t] != idx) continue;
+            if (hdr.opcode != opcode) run_shm_job(opcode, &tiles[t]);
+            owner[t] = -1;
+            w->in_flight--;
+            in_flight--;
+
+            if (next_tile < ntiles) {
+                owner[next_tile] = send_tile(w, opcode, base_id + next_tile,
+                                             &tiles[next_tile], &in_flight);
+                next_tile++;
+            }
+        }
+
+        // Every remaining worker may have died with tiles still unsent
+        if (in_flight == 0) break;
+    }
+
+    // Tiles never sent, or still owned after an epoll failure, finish locally
+    for (int t = 0; t < ntiles; t++) {
+        if (t >= next_tile || owner[t] != -1) run_shm_job(opcode, &tiles[t]);
+    }
+    for (int k = 0; k < nworkers; k++) {
+        workers[k]->in_flight = 0;
+        release_worker(workers[k]);
+    }
+
+    free(reply);
+    scratch_release(mark);
+}
+
 Matrix* add_matrices_with_pool(Matrix *m1, Matrix *m2) {
     if (m1->rows != m2->rows || m1->cols != m2->cols) {
         printf("Error: Matrices must have same dimensions\n");
@@ -317,95 +780,383 @@ Matrix* add_matrices_with_pool(Matrix *m1, Matrix *m2) {
     
     send_status_via_fifo("POOL_ADD_START");
     
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m1->cols; j++) {
-            Worker *w = get_available_worker();
-            if (!w) {
-                result->data[i][j] = m1->data[i][j] + m2->data[i][j];
-                continue;
-            }
-            
-            WorkMessage msg;
-            msg.op_type = OP_ADD;
-            msg.operand1 = m1->data[i][j];
-            msg.operand2 = m2->data[i][j];
-            
-            write(w->input_pipe[1], &msg, sizeof(WorkMessage));
-            read(w->output_pipe[0], &msg, sizeof(WorkMessage));
-            
-            result->data[i][j] = msg.result;
-            release_worker(w);
-        }
-    }
+    pool_arena_reset();
+    ShmJob job = {
+        .a_off = pool_arena_put_matrix(m1),
+        .b_off = pool_arena_put_matrix(m2),
+        .c_off = pool_arena_alloc((size_t)result->rows * result->stride * sizeof(double)),
+        .rows = m1->rows, .cols = m1->cols, .inner = 0,
+        .a_stride = m1->stride, .b_stride = m2->stride, .c_stride = result->stride
+    };
+    dispatch_row_blocks(OP_ADD, &job);
+    pool_arena_get_matrix(job.c_off, result);
     
     send_status_via_fifo("POOL_ADD_COMPLETE");
     return result;
 }
 
-// ===== FORK-BASED OPERATIONS (New Processes) =====
-Matrix* add_matrices_with_processes(Matrix *m1, Matrix *m2) {
+Matrix* subtract_matrices_with_pool(Matrix *m1, Matrix *m2) {
     if (m1->rows != m2->rows || m1->cols != m2->cols) {
         printf("Error: Matrices must have same dimensions\n");
         return NULL;
     }
     
     char result_name[128];
-    snprintf(result_name, sizeof(result_name), "%s_plus_%s", m1->name, m2->name);
+    snprintf(result_name, sizeof(result_name), "%s_minus_%s_pool", m1->name, m2->name);
     Matrix *result = create_matrix(m1->rows, m1->cols, result_name);
     
-    int total_elements = m1->rows * m1->cols;
+    send_status_via_fifo("POOL_SUBTRACT_START");
     
-    pid_t *pids = malloc(total_elements * sizeof(pid_t));
-    int (*pipes)[2] = malloc(total_elements * sizeof(int[2]));
+    pool_arena_reset();
+    ShmJob job = {
+        .a_off = pool_arena_put_matrix(m1),
+        .b_off = pool_arena_put_matrix(m2),
+        .c_off = pool_arena_alloc((size_t)result->rows * result->stride * sizeof(double)),
+        .rows = m1->rows, .cols = m1->cols, .inner = 0,
+        .a_stride = m1->stride, .b_stride = m2->stride, .c_stride = result->stride
+    };
+    dispatch_row_blocks(OP_SUBTRACT, &job);
+    pool_arena_get_matrix(job.c_off, result);
     
-    workers_completed = 0;
-    send_status_via_fifo("ADD_OPERATION_START");
+    send_status_via_fifo("POOL_SUBTRACT_COMPLETE");
+    return result;
+}
+
+Matrix* multiply_matrices_with_pool(Matrix *m1, Matrix *m2) {
+    if (m1->cols != m2->rows) {
+        printf("Error: Invalid dimensions\n");
+        return NULL;
+    }
     
-    int idx = 0;
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m1->cols; j++) {
-            if (pipe(pipes[idx]) == -1) {
-                perror("pipe");
-                exit(1);
-            }
-            
-            pid_t pid = fork();
-            if (pid < 0) {
-                perror("fork");
-                exit(1);
+    char result_name[128];
+    snprintf(result_name, sizeof(result_name), "%s_times_%s_pool", m1->name, m2->name);
+    Matrix *result = create_matrix(m1->rows, m2->cols, result_name);
+    
+    send_status_via_fifo("POOL_MULTIPLY_START");
+    
+    pool_arena_reset();
+    ShmJob job = {
+        .a_off = pool_arena_put_matrix(m1),
+        .b_off = pool_arena_put_matrix(m2),
+        .c_off = pool_arena_alloc((size_t)result->rows * result->stride * sizeof(double)),
+        .rows = m1->rows, .cols = m2->cols, .inner = m1->cols,
+        .a_stride = m1->stride, .b_stride = m2->stride, .c_stride = result->stride
+    };
+    dispatch_row_blocks(OP_GEMM_PANEL, &job);
+    pool_arena_get_matrix(job.c_off, result);
+    
+    send_status_via_fifo("POOL_MULTIPLY_COMPLETE");
+    return result;
+}
+
+// Blocked LU on the arena copy. The parent factors each LU_BLOCK-wide panel
+// and its U12 row strip; the O(n^3) trailing update A22 -= L21 * U12 is
+// split across the workers.
+double determinant_with_pool(Matrix *m) {
+    if (m->rows != m->cols) {
+        printf("Error: Matrix must be square\n");
+        return 0.0;
+    }
+    
+    int n = m->rows;
+    int lda = m->stride;
+    
+    send_status_via_fifo("POOL_DETERMINANT_START");
+    
+    pool_arena_reset();
+    uint64_t a_off = pool_arena_put_matrix(m);
+    double *A = pool_arena_ptr(a_off);
+    double sign = 1.0;
+    
+    for (int k0 = 0; k0 < n; k0 += LU_BLOCK) {
+        int kb = (n - k0 < LU_BLOCK) ? n - k0 : LU_BLOCK;
+        int k1 = k0 + kb;
+        
+        if (!lu_panel(n, k0, kb, A, lda, &sign, 0)) {
+            send_status_via_fifo("POOL_DETERMINANT_COMPLETE");
+            return 0.0;
+        }
+        if (k1 >= n) break;
+        
+        ShmJob job = {
+            .a_off = a_off + ((uint64_t)k1 * lda + k0) * sizeof(double),
+            .b_off = a_off + ((uint64_t)k0 * lda + k1) * sizeof(double),
+            .c_off = a_off + ((uint64_t)k1 * lda + k1) * sizeof(double),
+            .rows = n - k1, .cols = n - k1, .inner = kb,
+            .a_stride = lda, .b_stride = lda, .c_stride = lda
+        };
+        dispatch_row_blocks(OP_LU_UPDATE, &job);
+    }
+    
+    double det = sign;
+    for (int i = 0; i < n; i++) det *= A[(size_t)i * lda + i];
+    
+    send_status_via_fifo("POOL_DETERMINANT_COMPLETE");
+    return det;
+}
+
+// Send one request per resident partition and gather the replies. A
+// partition whose worker rejects the request or dies is handed back to the
+// parent for the rest of the solve (owner -1). For OP_PARTITION_MATVEC the
+// parent computes its own partitions from the arena copy while it waits.
+static void partition_round(uint32_t opcode, ShmJob *parts, int *owner, int nparts) {
+    int compute = (opcode == OP_PARTITION_MATVEC);
+    ScratchMark mark = scratch_mark();
+    int *pending = scratch_alloc(nparts * sizeof(int));
+    memset(pending, 0, nparts * sizeof(int));
+    uint32_t base_id = next_request_id;
+    next_request_id += (uint32_t)nparts;
+    int in_flight = 0;
+
+    for (int p = 0; p < nparts; p++) {
+        if (owner[p] < 0) continue;
+        Worker *w = &worker_pool[owner[p]];
+        struct iovec iov = {.iov_base = &parts[p], .iov_len = sizeof(parts[p])};
+        int sent = (opcode == OP_PARTITION_RELEASE)
+                       ? send_frame(w->input_pipe[1], opcode, base_id + p, NULL, 0)
+                       : send_frame(w->input_pipe[1], opcode, base_id + p, &iov, 1);
+        if (sent == 0) {
+            pending[p] = 1;
+            in_flight++;
+        } else {
+            retire_worker(w);
+            owner[p] = -1;
+        }
+    }
+
+    for (int p = 0; p < nparts; p++) {
+        if (compute && owner[p] < 0) run_shm_job(OP_MATRIX_VECTOR_MULTIPLY, &parts[p]);
+    }
+
+    void *reply = NULL;
+    size_t reply_cap = 0;
+    struct epoll_event events[MAX_WORKERS];
+
+    while (in_flight > 0) {
+        int nev = epoll_wait(pool_epoll_fd, events, MAX_WORKERS, -1);
+        if (nev < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (int e = 0; e < nev; e++) {
+            int idx = (int)events[e].data.u32;
+            int p = 0;
+            while (p < nparts && !(pending[p] && owner[p] == idx)) p++;
+            if (p == nparts) {
+                drain_idle_worker(&worker_pool[idx], &reply, &reply_cap);
+                continue;
             }
-            
-            if (pid == 0) {
-                close(pipes[idx][0]);
-                double result_val = m1->data[i][j] + m2->data[i][j];
-                write(pipes[idx][1], &result_val, sizeof(double));
-                close(pipes[idx][1]);
-                kill(getppid(), SIGUSR1);
-                exit(0);
+
+            FrameHeader hdr;
+            int ok = recv_frame(worker_pool[idx].output_pipe[0], &hdr, &reply, &reply_cap) == 0;
+            if (ok && hdr.request_id != base_id + (uint32_t)p) continue;
+            if (!ok) retire_worker(&worker_pool[idx]);
+            if (!ok || hdr.opcode != opcode) {
+                owner[p] = -1;
+                if (compute) run_shm_job(OP_MATRIX_VECTOR_MULTIPLY, &parts[p]);
             }
-            
-            close(pipes[idx][1]);
-            pids[idx] = pid;
-            idx++;
+            pending[p] = 0;
+            in_flight--;
         }
     }
+
+    // Replies lost to an epoll failure: take those partitions back
+    for (int p = 0; p < nparts; p++) {
+        if (!pending[p]) continue;
+        owner[p] = -1;
+        if (compute) run_shm_job(OP_MATRIX_VECTOR_MULTIPLY, &parts[p]);
+    }
+
+    free(reply);
+    scratch_release(mark);
+}
+
+// Power iteration on resident row partitions. Each worker is sent its
+// contiguous block of rows once (OP_PARTITION_LOAD) and keeps a private copy;
+// every iteration then only writes the current vector into the arena and
+// exchanges one small frame per worker. Normalisation and the Rayleigh
+// quotient stay in the parent.
+void compute_eigen_with_pool(Matrix *m, double *eigenvalue, double *eigenvector) {
+    if (m->rows != m->cols) {
+        printf("Error: Invalid matrix\n");
+        return;
+    }
     
-    idx = 0;
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m1->cols; j++) {
-            double result_val;
-            ssize_t n = read(pipes[idx][0], &result_val, sizeof(double));
-            if (n > 0) {
-                result->data[i][j] = result_val;
-            }
-            close(pipes[idx][0]);
-            waitpid(pids[idx], NULL, 0);
-            idx++;
+    int n = m->rows;
+    
+    send_status_via_fifo("POOL_EIGEN_START");
+    
+    pool_arena_reset();
+    uint64_t a_off = pool_arena_put_matrix(m);
+    uint64_t v_off = pool_arena_alloc((size_t)n * sizeof(double));
+    uint64_t v_new_off = pool_arena_alloc((size_t)n * sizeof(double));
+    double *v = pool_arena_ptr(v_off);
+    double *v_new = pool_arena_ptr(v_new_off);
+    
+    Worker *workers[MAX_WORKERS];
+    int nworkers = 0;
+    Worker *w;
+    while (nworkers < MAX_WORKERS && nworkers < n &&
+           (w = get_available_worker()) != NULL) {
+        workers[nworkers++] = w;
+    }
+    
+    int nparts = nworkers > 0 ? nworkers : 1;
+    int chunk = (n + nparts - 1) / nparts;
+    if (chunk == 0) chunk = 1;
+    ShmJob parts[nparts];
+    int owner[nparts];
+    for (int p = 0; p < nparts; p++) {
+        int r0 = p * chunk < n ? p * chunk : n;
+        int r1 = r0 + chunk < n ? r0 + chunk : n;
+        parts[p] = (ShmJob){
+            .a_off = a_off + (uint64_t)r0 * m->stride * sizeof(double),
+            .b_off = v_off,
+            .c_off = v_new_off + (uint64_t)r0 * sizeof(double),
+            .rows = r1 - r0, .cols = 1, .inner = n,
+            .a_stride = m->stride, .b_stride = n, .c_stride = 1,
+            .arena_size = arena_size
+        };
+        owner[p] = (p < nworkers) ? (int)(workers[p] - worker_pool) : -1;
+    }
+    
+    partition_round(OP_PARTITION_LOAD, parts, owner, nparts);
+    
+    for (int i = 0; i < n; i++) v[i] = 1.0 / sqrt((double)n);
+    
+    int max_iterations = 1000;
+    double tolerance = 1e-6;
+    double lambda = 0.0;
+    
+    for (int iter = 0; iter < max_iterations; iter++) {
+        partition_round(OP_PARTITION_MATVEC, parts, owner, nparts);
+        
+        lambda = 0.0;
+        double norm = 0.0;
+        for (int i = 0; i < n; i++) {
+            lambda += v_new[i] * v[i];
+            norm += v_new[i] * v_new[i];
         }
+        norm = sqrt(norm);
+        if (norm == 0.0) break;
+        
+        double diff = 0.0;
+        for (int i = 0; i < n; i++) {
+            double next = v_new[i] / norm;
+            diff += fabs(next - v[i]);
+            v[i] = next;
+        }
+        
+        if (diff < tolerance) break;
     }
     
-    free(pids);
-    free(pipes);
+    partition_round(OP_PARTITION_RELEASE, parts, owner, nparts);
+    for (int k = 0; k < nworkers; k++) release_worker(workers[k]);
+    
+    *eigenvalue = lambda;
+    for (int i = 0; i < n; i++) {
+        eigenvector[i] = v[i];
+    }
+    
+    send_status_via_fifo("POOL_EIGEN_COMPLETE");
+}
+
+// ===== FORK-BASED OPERATIONS (New Processes) =====
+// Each operation forks at most fork_children processes (core count by
+// default). Every child computes one contiguous block of output rows into a
+// MAP_SHARED buffer, so no per-element pipes or descriptors are needed.
+typedef void (*RowBlockKernel)(Matrix *m1, Matrix *m2, double *out, int out_stride,
+                               int row_begin, int row_end);
+
+static void add_row_block(Matrix *m1, Matrix *m2, double *out, int out_stride,
+                          int row_begin, int row_end) {
+    for (int i = row_begin; i < row_end; i++) {
+        const double *a = MATRIX_ROW(m1, i);
+        const double *b = MATRIX_ROW(m2, i);
+        double *c = out + (size_t)i * out_stride;
+        for (int j = 0; j < m1->cols; j++) c[j] = a[j] + b[j];
+    }
+}
+
+static void subtract_row_block(Matrix *m1, Matrix *m2, double *out, int out_stride,
+                               int row_begin, int row_end) {
+    for (int i = row_begin; i < row_end; i++) {
+        const double *a = MATRIX_ROW(m1, i);
+        const double *b = MATRIX_ROW(m2, i);
+        double *c = out + (size_t)i * out_stride;
+        for (int j = 0; j < m1->cols; j++) c[j] = a[j] - b[j];
+    }
+}
+
+static void multiply_row_block(Matrix *m1, Matrix *m2, double *out, int out_stride,
+                               int row_begin, int row_end) {
+    gemm(row_end - row_begin, m2->cols, m1->cols, 1.0,
+         MATRIX_ROW(m1, row_begin), m1->stride, m2->storage, m2->stride,
+         0.0, out + (size_t)row_begin * out_stride, out_stride);
+}
+
+int fork_child_count(int work_items) {
+    int n = fork_children > 0 ? fork_children : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > work_items) n = work_items;
+    return n;
+}
+
+static void fork_row_blocks(Matrix *m1, Matrix *m2, Matrix *result, RowBlockKernel kernel) {
+    size_t bytes = (size_t)result->rows * result->stride * sizeof(double);
+    if (result->rows == 0 || bytes == 0) return;
+
+    double *shared = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        perror("mmap");
+        kernel(m1, m2, result->storage, result->stride, 0, result->rows);
+        return;
+    }
+
+    int nchildren = fork_child_count(result->rows);
+    int chunk = (result->rows + nchildren - 1) / nchildren;
+    pid_t pids[nchildren];
+    int spawned = 0;
+
+    workers_completed = 0;
+    for (int r0 = 0; r0 < result->rows; r0 += chunk) {
+        int r1 = (r0 + chunk < result->rows) ? r0 + chunk : result->rows;
+        pid_t pid = fork();
+        if (pid == 0) {
+            kernel(m1, m2, shared, result->stride, r0, r1);
+            kill(getppid(), SIGUSR1);
+            _exit(0);
+        }
+        if (pid < 0) {
+            // Out of processes: the parent takes this block itself
+            kernel(m1, m2, shared, result->stride, r0, r1);
+            continue;
+        }
+        pids[spawned++] = pid;
+    }
+
+    for (int i = 0; i < spawned; i++) {
+        while (waitpid(pids[i], NULL, 0) == -1 && errno == EINTR);
+    }
+
+    memcpy(result->storage, shared, bytes);
+    munmap(shared, bytes);
+}
+
+Matrix* add_matrices_with_processes(Matrix *m1, Matrix *m2) {
+    if (m1->rows != m2->rows || m1->cols != m2->cols) {
+        printf("Error: Matrices must have same dimensions\n");
+        return NULL;
+    }
+    
+    char result_name[128];
+    snprintf(result_name, sizeof(result_name), "%s_plus_%s", m1->name, m2->name);
+    Matrix *result = create_matrix(m1->rows, m1->cols, result_name);
+    
+    send_status_via_fifo("ADD_OPERATION_START");
+    fork_row_blocks(m1, m2, result, add_row_block);
     send_status_via_fifo("ADD_OPERATION_COMPLETE");
     
     return result;
@@ -421,57 +1172,8 @@ Matrix* subtract_matrices_with_processes(Matrix *m1, Matrix *m2) {
     snprintf(result_name, sizeof(result_name), "%s_minus_%s", m1->name, m2->name);
     Matrix *result = create_matrix(m1->rows, m1->cols, result_name);
     
-    int total_elements = m1->rows * m1->cols;
-    
-    pid_t *pids = malloc(total_elements * sizeof(pid_t));
-    int (*pipes)[2] = malloc(total_elements * sizeof(int[2]));
-    
-    workers_completed = 0;
     send_status_via_fifo("SUBTRACT_OPERATION_START");
-    
-    int idx = 0;
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m1->cols; j++) {
-            if (pipe(pipes[idx]) == -1) {
-                perror("pipe");
-                exit(1);
-            }
-            
-            pid_t pid = fork();
-            if (pid < 0) {
-                perror("fork");
-                exit(1);
-            }
-            
-            if (pid == 0) {
-                close(pipes[idx][0]);
-                double result_val = m1->data[i][j] - m2->data[i][j];
-                write(pipes[idx][1], &result_val, sizeof(double));
-                close(pipes[idx][1]);
-                kill(getppid(), SIGUSR1);
-                exit(0);
-            }
-            
-            close(pipes[idx][1]);
-            pids[idx] = pid;
-            idx++;
-        }
-    }
-    
-    idx = 0;
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m1->cols; j++) {
-            double result_val;
-            read(pipes[idx][0], &result_val, sizeof(double));
-            result->data[i][j] = result_val;
-            close(pipes[idx][0]);
-            waitpid(pids[idx], NULL, 0);
-            idx++;
-        }
-    }
-    
-    free(pids);
-    free(pipes);
+    fork_row_blocks(m1, m2, result, subtract_row_block);
     send_status_via_fifo("SUBTRACT_OPERATION_COMPLETE");
     
     return result;
@@ -487,94 +1189,87 @@ Matrix* multiply_matrices_with_processes(Matrix *m1, Matrix *m2) {
     snprintf(result_name, sizeof(result_name), "%s_times_%s", m1->name, m2->name);
     Matrix *result = create_matrix(m1->rows, m2->cols, result_name);
     
-    int total_processes = m1->rows * m2->cols;
-    pid_t *pids = malloc(total_processes * sizeof(pid_t));
-    int (*pipes)[2] = malloc(total_processes * sizeof(int[2]));
-    
-    workers_completed = 0;
     send_status_via_fifo("MULTIPLY_OPERATION_START");
-    int idx = 0;
-    
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m2->cols; j++) {
-            if (pipe(pipes[idx]) == -1) {
-                perror("pipe");
-                exit(1);
-            }
-            
-            pid_t pid = fork();
-            if (pid < 0) {
-                perror("fork");
-                exit(1);
-            }
-            
-            if (pid == 0) {
-                close(pipes[idx][0]);
-                
-                double result_val = 0.0;
-                for (int k = 0; k < m1->cols; k++) {
-                    result_val += m1->data[i][k] * m2->data[k][j];
-                }
-                
-                write(pipes[idx][1], &result_val, sizeof(double));
-                close(pipes[idx][1]);
-                kill(getppid(), SIGUSR1);
-                exit(0);
-            }
-            
-            close(pipes[idx][1]);
-            pids[idx] = pid;
-            idx++;
-        }
-    }
-    
-    idx = 0;
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m2->cols; j++) {
-            double result_val;
-            read(pipes[idx][0], &result_val, sizeof(double));
-            result->data[i][j] = result_val;
-            close(pipes[idx][0]);
-            waitpid(pids[idx], NULL, 0);
-            idx++;
-        }
-    }
-    
-    free(pids);
-    free(pipes);
+    fork_row_blocks(m1, m2, result, multiply_row_block);
     send_status_via_fifo("MULTIPLY_OPERATION_COMPLETE");
     return result;
 }
 
-double determinant_recursive_processes(Matrix *m) {
-    if (m->rows != m->cols) return 0.0;
+// Blocked LU on a MAP_SHARED copy. The parent factors each panel, then forks
+// up to fork_children processes that each apply the trailing update to a
+// contiguous block of rows. Wider panels than LU_BLOCK amortise the forks.
+#define FORK_LU_BLOCK 128
+#define FORK_LU_MIN_ROWS 64
+double determinant_with_processes(Matrix *m) {
+    if (m->rows != m->cols) {
+        printf("Error: Matrix must be square\n");
+        return 0.0;
+    }
     
     int n = m->rows;
+    int lda = m->stride;
+    size_t bytes = (size_t)n * lda * sizeof(double);
+    if (bytes == 0) return 1.0;
+    
+    double *A = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (A == MAP_FAILED) {
+        perror("mmap");
+        return determinant_single(m);
+    }
+    memcpy(A, m->storage, bytes);
     
-    if (n == 1) return m->data[0][0];
-    if (n == 2) return m->data[0][0] * m->data[1][1] - m->data[0][1] * m->data[1][0];
+    send_status_via_fifo("DETERMINANT_OPERATION_START");
     
+    double sign = 1.0;
     double det = 0.0;
+    int singular = 0;
     
-    #pragma omp parallel for reduction(+:det)
-    for (int j = 0; j < n; j++) {
-        Matrix *sub = create_matrix(n-1, n-1, "temp_sub");
-        for (int i = 1; i < n; i++) {
-            int col_idx = 0;
-            for (int k = 0; k < n; k++) {
-                if (k != j) {
-                    sub->data[i-1][col_idx++] = m->data[i][k];
-                }
-            }
+    for (int k0 = 0; k0 < n; k0 += FORK_LU_BLOCK) {
+        int kb = (n - k0 < FORK_LU_BLOCK) ? n - k0 : FORK_LU_BLOCK;
+        int k1 = k0 + kb;
+        
+        if (!lu_panel(n, k0, kb, A, lda, &sign, 0)) {
+            singular = 1;
+            break;
         }
+        if (k1 >= n) break;
+        
+        int rows = n - k1;
+        const double *U12 = A + (size_t)k0 * lda + k1;
+        int nchildren = fork_child_count((rows + FORK_LU_MIN_ROWS - 1) / FORK_LU_MIN_ROWS);
+        int chunk = (rows + nchildren - 1) / nchildren;
+        pid_t pids[nchildren];
+        int spawned = 0;
         
-        double sign = (j % 2 == 0) ? 1.0 : -1.0;
-        double sub_det = determinant_openmp(sub);
-        det += sign * m->data[0][j] * sub_det;
+        for (int r0 = k1; r0 < n; r0 += chunk) {
+            int r1 = (r0 + chunk < n) ? r0 + chunk : n;
+            const double *L21 = A + (size_t)r0 * lda + k0;
+            double *A22 = A + (size_t)r0 * lda + k1;
+            pid_t pid = (nchildren > 1) ? fork() : -1;
+            if (pid == 0) {
+                gemm(r1 - r0, rows, kb, -1.0, L21, lda, U12, lda, 1.0, A22, lda);
+                _exit(0);
+            }
+            if (pid < 0) {
+                gemm(r1 - r0, rows, kb, -1.0, L21, lda, U12, lda, 1.0, A22, lda);
+                continue;
+            }
+            pids[spawned++] = pid;
+        }
         
-        free_matrix(sub);
+        for (int i = 0; i < spawned; i++) {
+            while (waitpid(pids[i], NULL, 0) == -1 && errno == EINTR);
+        }
+    }
+    
+    if (!singular) {
+        det = sign;
+        for (int i = 0; i < n; i++) det *= A[(size_t)i * lda + i];
     }
     
+    munmap(A, bytes);
+    send_status_via_fifo("DETERMINANT_OPERATION_COMPLETE");
     return det;
 }
 
@@ -587,8 +1282,11 @@ Matrix* add_matrices_single(Matrix *m1, Matrix *m2) {
     Matrix *result = create_matrix(m1->rows, m1->cols, result_name);
     
     for (int i = 0; i < m1->rows; i++) {
+        const double *a = MATRIX_ROW(m1, i);
+        const double *b = MATRIX_ROW(m2, i);
+        double *c = MATRIX_ROW(result, i);
         for (int j = 0; j < m1->cols; j++) {
-            result->data[i][j] = m1->data[i][j] + m2->data[i][j];
+            c[j] = a[j] + b[j];
         }
     }
     
@@ -603,8 +1301,11 @@ Matrix* subtract_matrices_single(Matrix *m1, Matrix *m2) {
     Matrix *result = create_matrix(m1->rows, m1->cols, result_name);
     
     for (int i = 0; i < m1->rows; i++) {
+        const double *a = MATRIX_ROW(m1, i);
+        const double *b = MATRIX_ROW(m2, i);
+        double *c = MATRIX_ROW(result, i);
         for (int j = 0; j < m1->cols; j++) {
-            result->data[i][j] = m1->data[i][j] - m2->data[i][j];
+            c[j] = a[j] - b[j];
         }
     }
     
@@ -618,54 +1319,31 @@ Matrix* multiply_matrices_single(Matrix *m1, Matrix *m2) {
     snprintf(result_name, sizeof(result_name), "%s_times_%s_single", m1->name, m2->name);
     Matrix *result = create_matrix(m1->rows, m2->cols, result_name);
     
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m2->cols; j++) {
-            result->data[i][j] = 0.0;
-            for (int k = 0; k < m1->cols; k++) {
-                result->data[i][j] += m1->data[i][k] * m2->data[k][j];
-            }
-        }
-    }
+    gemm(m1->rows, m2->cols, m1->cols, 1.0, m1->storage, m1->stride,
+         m2->storage, m2->stride, 0.0, result->storage, result->stride);
     
     return result;
 }
 
 double determinant_single(Matrix *m) {
     if (m->rows != m->cols) return 0.0;
-    int n = m->rows;
-    
-    if (n == 1) return m->data[0][0];
-    if (n == 2) return m->data[0][0] * m->data[1][1] - m->data[0][1] * m->data[1][0];
     
-    double det = 0.0;
-    for (int j = 0; j < n; j++) {
-        Matrix *sub = create_matrix(n-1, n-1, "temp_sub");
-        for (int i = 1; i < n; i++) {
-            int col_idx = 0;
-            for (int k = 0; k < n; k++) {
-                if (k != j) sub->data[i-1][col_idx++] = m->data[i][k];
-            }
-        }
-        double sign = (j % 2 == 0) ? 1.0 : -1.0;
-        det += sign * m->data[0][j] * determinant_single(sub);
-        free_matrix(sub);
-    }
+    Matrix *work = matrix_share(m, "lu_work");
+    matrix_make_writable(work);
+    double det = lu_determinant(work->rows, work->storage, work->stride, 0);
+    free_matrix(work);
     return det;
 }
 
-double determinant_with_processes(Matrix *m) {
-    if (m->rows != m->cols) {
-        printf("Error: Matrix must be square\n");
-        return 0.0;
-    }
-    
-    return determinant_recursive_processes(m);
-}
-
 double determinant_parallel(Matrix *m) {
     return determinant_with_processes(m);
 }
 
+// Power iteration with the children forked once per solve rather than once
+// per row per iteration. Each child owns a contiguous block of rows of its
+// inherited copy of m; per iteration the parent writes v into a MAP_SHARED
+// buffer, wakes every child with one byte on its command pipe and waits for
+// one byte back. A zero byte tells the child to exit.
 void compute_eigen_with_processes(Matrix *m, int num_eigenvalues, double *eigenvalues, double **eigenvectors) {
     (void)num_eigenvalues;
     if (m->rows != m->cols) {
@@ -674,113 +1352,121 @@ void compute_eigen_with_processes(Matrix *m, int num_eigenvalues, double *eigenv
     }
     
     int n = m->rows;
+    if (n == 0) return;
+    
+    size_t bytes = 2 * (size_t)n * sizeof(double);
+    double *shared = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    double *v = shared;
+    double *v_new = shared + n;
     
-    double *v = malloc(n * sizeof(double));
-    double *v_new = malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) v[i] = 1.0 / sqrt((double)n);
     
-    for (int i = 0; i < n; i++) {
-        v[i] = 1.0;
-    }
+    int nchildren = fork_child_count(n);
+    int chunk = (n + nchildren - 1) / nchildren;
+    nchildren = (n + chunk - 1) / chunk;
+    pid_t pids[nchildren];
+    int cmd[nchildren][2];
+    int done[nchildren][2];
     
-    double norm = 0.0;
-    for (int i = 0; i < n; i++) {
-        norm += v[i] * v[i];
-    }
-    norm = sqrt(norm);
-    for (int i = 0; i < n; i++) {
-        v[i] /= norm;
+    for (int c = 0; c < nchildren; c++) {
+        if (pipe(cmd[c]) == -1 || pipe(done[c]) == -1) {
+            perror("pipe");
+            exit(1);
+        }
+        
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            exit(1);
+        }
+        
+        if (pid == 0) {
+            for (int k = 0; k < c; k++) {
+                close(cmd[k][1]);
+                close(done[k][0]);
+            }
+            close(cmd[c][1]);
+            close(done[c][0]);
+            
+            int r0 = c * chunk;
+            int r1 = (r0 + chunk < n) ? r0 + chunk : n;
+            char go;
+            while (read_full(cmd[c][0], &go, 1) == 0 && go) {
+                for (int i = r0; i < r1; i++) {
+                    const double *row = MATRIX_ROW(m, i);
+                    double sum = 0.0;
+                    for (int j = 0; j < n; j++) sum += row[j] * v[j];
+                    v_new[i] = sum;
+                }
+                if (write(done[c][1], &go, 1) != 1) break;
+            }
+            _exit(0);
+        }
+        
+        close(cmd[c][0]);
+        close(done[c][1]);
+        pids[c] = pid;
     }
     
     int max_iterations = 1000;
     double tolerance = 1e-6;
+    double lambda = 0.0;
     
     for (int iter = 0; iter < max_iterations; iter++) {
-        pid_t *pids = malloc(n * sizeof(pid_t));
-        int (*pipes)[2] = malloc(n * sizeof(int[2]));
-        
-        workers_completed = 0;
-        
-        for (int i = 0; i < n; i++) {
-            if (pipe(pipes[i]) == -1) {
-                perror("pipe");
+        char go = 1;
+        for (int c = 0; c < nchildren; c++) {
+            if (write(cmd[c][1], &go, 1) != 1) {
+                perror("write");
                 exit(1);
             }
-            
-            pid_t pid = fork();
-            if (pid < 0) {
-                perror("fork");
+        }
+        for (int c = 0; c < nchildren; c++) {
+            if (read_full(done[c][0], &go, 1) == -1) {
+                printf("Error: eigen child %d exited early\n", c);
                 exit(1);
             }
-            
-            if (pid == 0) {
-                close(pipes[i][0]);
-                
-                double row_result = 0.0;
-                for (int j = 0; j < n; j++) {
-                    row_result += m->data[i][j] * v[j];
-                }
-                
-                write(pipes[i][1], &row_result, sizeof(double));
-                close(pipes[i][1]);
-                
-                kill(getppid(), SIGUSR1);
-                exit(0);
-            }
-            
-            close(pipes[i][1]);
-            pids[i] = pid;
-        }
-        
-        for (int i = 0; i < n; i++) {
-            read(pipes[i][0], &v_new[i], sizeof(double));
-            close(pipes[i][0]);
-            waitpid(pids[i], NULL, 0);
         }
         
-        free(pids);
-        free(pipes);
-        
-        double lambda = 0.0;
+        lambda = 0.0;
+        double norm = 0.0;
         for (int i = 0; i < n; i++) {
             lambda += v_new[i] * v[i];
-        }
-        
-        norm = 0.0;
-        for (int i = 0; i < n; i++) {
             norm += v_new[i] * v_new[i];
         }
         norm = sqrt(norm);
-        for (int i = 0; i < n; i++) {
-            v_new[i] /= norm;
-        }
+        if (norm == 0.0) break;
         
         double diff = 0.0;
         for (int i = 0; i < n; i++) {
-            diff += fabs(v_new[i] - v[i]);
+            double next = v_new[i] / norm;
+            diff += fabs(next - v[i]);
+            v[i] = next;
         }
         
-        if (diff < tolerance) {
-            eigenvalues[0] = lambda;
-            for (int i = 0; i < n; i++) {
-                eigenvectors[0][i] = v_new[i];
-            }
-            break;
-        }
-        
-        for (int i = 0; i < n; i++) {
-            v[i] = v_new[i];
-        }
-        
-        if (iter == max_iterations - 1) {
-            eigenvalues[0] = lambda;
-            for (int i = 0; i < n; i++) {
-                eigenvectors[0][i] = v[i];
-            }
-        }
+        if (diff < tolerance) break;
+    }
+    
+    for (int c = 0; c < nchildren; c++) {
+        char stop = 0;
+        if (write(cmd[c][1], &stop, 1) != 1) kill(pids[c], SIGTERM);
+        close(cmd[c][1]);
+        close(done[c][0]);
+    }
+    for (int c = 0; c < nchildren; c++) {
+        while (waitpid(pids[c], NULL, 0) == -1 && errno == EINTR);
     }
     
-    free(v);
-    free(v_new);
+    eigenvalues[0] = lambda;
+    for (int i = 0; i < n; i++) {
+        eigenvectors[0][i] = v[i];
+    }
+    
+    munmap(shared, bytes);
 }
 
 // ===== OPENMP OPERATIONS =====
@@ -794,10 +1480,13 @@ Matrix* add_matrices_openmp(Matrix *m1, Matrix *m2) {
     snprintf(result_name, sizeof(result_name), "%s_plus_%s_openmp", m1->name, m2->name);
     Matrix *result = create_matrix(m1->rows, m1->cols, result_name);
     
-    #pragma omp parallel for collapse(2)
+    #pragma omp parallel for
     for (int i = 0; i < m1->rows; i++) {
+        const double *a = MATRIX_ROW(m1, i);
+        const double *b = MATRIX_ROW(m2, i);
+        double *c = MATRIX_ROW(result, i);
         for (int j = 0; j < m1->cols; j++) {
-            result->data[i][j] = m1->data[i][j] + m2->data[i][j];
+            c[j] = a[j] + b[j];
         }
     }
     
@@ -814,10 +1503,13 @@ Matrix* subtract_matrices_openmp(Matrix *m1, Matrix *m2) {
     snprintf(result_name, sizeof(result_name), "%s_minus_%s_openmp", m1->name, m2->name);
     Matrix *result = create_matrix(m1->rows, m1->cols, result_name);
     
-    #pragma omp parallel for collapse(2)
+    #pragma omp parallel for
     for (int i = 0; i < m1->rows; i++) {
+        const double *a = MATRIX_ROW(m1, i);
+        const double *b = MATRIX_ROW(m2, i);
+        double *c = MATRIX_ROW(result, i);
         for (int j = 0; j < m1->cols; j++) {
-            result->data[i][j] = m1->data[i][j] - m2->data[i][j];
+            c[j] = a[j] - b[j];
         }
     }
     
@@ -834,106 +1526,43 @@ Matrix* multiply_matrices_openmp(Matrix *m1, Matrix *m2) {
     snprintf(result_name, sizeof(result_name), "%s_times_%s_openmp", m1->name, m2->name);
     Matrix *result = create_matrix(m1->rows, m2->cols, result_name);
     
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < m1->rows; i++) {
-        for (int j = 0; j < m2->cols; j++) {
-            result->data[i][j] = 0.0;
-            for (int k = 0; k < m1->cols; k++) {
-                result->data[i][j] += m1->data[i][k] * m2->data[k][j];
-            }
-        }
-    }
+    gemm_parallel(m1->rows, m2->cols, m1->cols, 1.0, m1->storage, m1->stride,
+                  m2->storage, m2->stride, 0.0, result->storage, result->stride);
     
     return result;
 }
 
-double determinant_openmp(Matrix *m) {
-    if (m->rows != m->cols) {
-        printf("Error: Matrix must be square\n");
-        return 0.0;
+// Strassen recursion for square products; other shapes use the blocked kernel
+Matrix* multiply_matrices_strassen(Matrix *m1, Matrix *m2) {
+    if (m1->cols != m2->rows) {
+        printf("Error: Invalid dimensions\n");
+        return NULL;
     }
 
-    int n = m->rows;
-    if (n == 1) return m->data[0][0];
-    if (n == 2) return m->data[0][0] * m->data[1][1] - m->data[0][1] * m->data[1][0];
-
-    double det = 0.0;
-
-    #pragma omp parallel for reduction(+:det)
-    for (int j = 0; j < n; j++) {
-        Matrix *sub = create_matrix(n - 1, n - 1, "submatrix");
-        for (int i = 1; i < n; i++) {
-            int col_idx = 0;
-            for (int k = 0; k < n; k++) {
-                if (k != j) {
-                    sub->data[i - 1][col_idx++] = m->data[i][k];
-                }
-            }
-        }
-
-        double sign = (j % 2 == 0) ? 1.0 : -1.0;
-        double sub_det = determinant_openmp(sub);
-        det += sign * m->data[0][j] * sub_det;
+    char result_name[128];
+    snprintf(result_name, sizeof(result_name), "%s_times_%s_strassen", m1->name, m2->name);
+    Matrix *result = create_matrix(m1->rows, m2->cols, result_name);
 
-        free_matrix(sub);
+    if (m1->rows == m1->cols && m2->rows == m2->cols) {
+        gemm_strassen(m1->rows, m1->storage, m1->stride, m2->storage, m2->stride,
+                      result->storage, result->stride);
+    } else {
+        gemm_parallel(m1->rows, m2->cols, m1->cols, 1.0, m1->storage, m1->stride,
+                      m2->storage, m2->stride, 0.0, result->storage, result->stride);
     }
 
-    return det;
+    return result;
 }
 
-void compute_eigen_openmp(Matrix *m, int num_eigenvalues, double *eigenvalues, double **eigenvectors) {
-    (void)num_eigenvalues;
-
+double determinant_openmp(Matrix *m) {
     if (m->rows != m->cols) {
-        printf("Error: Matrix must be square for eigenvalue computation\n");
-        return;
-    }
-
-    int n = m->rows;
-    double *v = malloc(n * sizeof(double));
-    double *v_new = malloc(n * sizeof(double));
-
-    for (int i = 0; i < n; i++) v[i] = 1.0;
-
-    double norm = 0.0;
-    for (int i = 0; i < n; i++) norm += v[i] * v[i];
-    norm = sqrt(norm);
-    for (int i = 0; i < n; i++) v[i] /= norm;
-
-    int max_iterations = 1000;
-    double tolerance = 1e-6;
-
-    for (int iter = 0; iter < max_iterations; iter++) {
-        #pragma omp parallel for
-        for (int i = 0; i < n; i++) {
-            double sum = 0.0;
-            for (int j = 0; j < n; j++) {
-                sum += m->data[i][j] * v[j];
-            }
-            v_new[i] = sum;
-        }
-
-        double lambda = 0.0;
-        for (int i = 0; i < n; i++) lambda += v_new[i] * v[i];
-
-        norm = 0.0;
-        for (int i = 0; i < n; i++) norm += v_new[i] * v_new[i];
-        norm = sqrt(norm);
-
-        for (int i = 0; i < n; i++) v_new[i] /= norm;
-
-        double diff = 0.0;
-        for (int i = 0; i < n; i++) diff += fabs(v_new[i] - v[i]);
-
-        if (diff < tolerance) {
-            eigenvalues[0] = lambda;
-            for (int i = 0; i < n; i++) eigenvectors[0][i] = v_new[i];
-            break;
-        }
-
-        for (int i = 0; i < n; i++) v[i] = v_new[i];
+        printf("Error: Matrix must be square\n");
+        return 0.0;
     }
 
-    free(v);
-    free(v_new);
+    Matrix *work = matrix_share(m, "lu_work");
+    matrix_make_writable(work);
+    double det = lu_determinant(work->rows, work->storage, work->stride, 1);
+    free_matrix(work);
+    return det;
 }
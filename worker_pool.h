@@ -1,7 +1,9 @@
 #ifndef WORKER_POOL_H
 #define WORKER_POOL_H
 
+#include <stdint.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <time.h>
 #include "matrix.h"
 
@@ -13,33 +15,65 @@ typedef struct {
     time_t last_used;
     int available;
     int alive;
+    int in_flight;
 } Worker;
 
 // ===== Operation Types =====
 typedef enum {
     OP_ADD,
     OP_SUBTRACT,
-    OP_MULTIPLY_ELEMENT,
+    OP_GEMM_PANEL,
+    OP_LU_UPDATE,
     OP_DETERMINANT_2X2,
     OP_MATRIX_VECTOR_MULTIPLY,
-    OP_EXIT
+    OP_PARTITION_LOAD,
+    OP_PARTITION_MATVEC,
+    OP_PARTITION_RELEASE,
+    OP_EXIT,
+    OP_ERROR
 } OperationType;
 
-// ===== Message Structure =====
-#define MAX_VECTOR_SIZE 2000
-#define MAX_MATRIX_SIZE 100
+// ===== Shared Job Descriptor =====
+// Operands and results live in the pool's shared arena; a job names them by
+// byte offset. Strides are in doubles. arena_size is the arena size the
+// offsets were computed against, so workers know when to remap.
 typedef struct {
-    OperationType op_type;
-    double operand1;
-    double operand2;
-    double result;
-    int row_size;
-    int matrix_size;
-    double row_data[MAX_VECTOR_SIZE];
-    double col_data[MAX_VECTOR_SIZE];
-    double matrix_data[MAX_MATRIX_SIZE][MAX_MATRIX_SIZE];
-    double vector_data[MAX_VECTOR_SIZE];
-} WorkMessage;
+    uint64_t a_off;
+    uint64_t b_off;
+    uint64_t c_off;
+    int32_t rows;
+    int32_t cols;
+    int32_t inner;
+    int32_t a_stride;
+    int32_t b_stride;
+    int32_t c_stride;
+    uint64_t arena_size;
+} ShmJob;
+
+// ===== Wire Protocol =====
+// Every request and reply is a FrameHeader followed by exactly payload_len
+// bytes. Replies echo the opcode and request_id of the request they answer;
+// a malformed request is answered with OP_ERROR and an empty payload.
+//
+// Payload layouts:
+//   OP_ADD, OP_SUBTRACT        ShmJob: c = a +/- b over rows x cols
+//   OP_GEMM_PANEL              ShmJob: c = a (rows x inner) * b (inner x cols)
+//   OP_LU_UPDATE               ShmJob: c -= a (rows x inner) * b (inner x cols)
+//   OP_MATRIX_VECTOR_MULTIPLY  ShmJob: c (rows x 1) = a (rows x inner) * b[inner]
+//   OP_PARTITION_LOAD          ShmJob: copy a (rows x inner) into the worker
+//   OP_PARTITION_MATVEC        ShmJob: c (rows x 1) = resident rows * b[inner]
+//   OP_PARTITION_RELEASE       (empty): drop the resident rows
+//   OP_DETERMINANT_2X2         double a00, a01, a10, a11 -> 1 double
+//   OP_EXIT                    (empty)                   -> no reply
+// ShmJob requests are answered with an empty payload once c is written.
+// A worker holds at most one resident partition; a new LOAD replaces it, and
+// a MATVEC whose rows/inner do not match it is rejected.
+#define FRAME_MAX_IOV 8
+typedef struct {
+    uint32_t opcode;
+    uint32_t request_id;
+    uint64_t payload_len;
+} FrameHeader;
 
 // ✅ FIFO Status Message
 typedef struct {
@@ -51,9 +85,12 @@ typedef struct {
 
 // ===== Global Pool =====
 #define MAX_WORKERS 100
+#define POOL_TILES_PER_WORKER 4
+#define POOL_MAX_IN_FLIGHT 2
 extern Worker *worker_pool;
 extern int pool_size;
 extern int max_idle_time;
+extern int fork_children;
 
 // ===== Worker Pool Management =====
 void init_worker_pool(int size);
@@ -63,7 +100,20 @@ void release_worker(Worker *w);
 void age_workers(void);
 void worker_process_loop(int input_fd, int output_fd);
 
+// ===== Framed IPC =====
+int send_frame(int fd, uint32_t opcode, uint32_t request_id,
+               const struct iovec *payload, int iovcnt);
+int recv_frame(int fd, FrameHeader *hdr, void **payload, size_t *capacity);
+
+// ===== Shared Operand Arena =====
+uint64_t pool_arena_alloc(size_t bytes);
+void *pool_arena_ptr(uint64_t offset);
+void pool_arena_reset(void);
+uint64_t pool_arena_put_matrix(Matrix *m);
+void pool_arena_get_matrix(uint64_t offset, Matrix *m);
+
 // ===== Matrix Operations - Fork-based (New Processes) =====
+int fork_child_count(int work_items);
 Matrix* add_matrices_with_processes(Matrix *m1, Matrix *m2);
 Matrix* subtract_matrices_with_processes(Matrix *m1, Matrix *m2);
 Matrix* multiply_matrices_with_processes(Matrix *m1, Matrix *m2);
@@ -71,11 +121,17 @@ double determinant_with_processes(Matrix *m);
 
 // ===== ✅ ADDED: Matrix Operations - Worker Pool (Persistent Processes) =====
 Matrix* add_matrices_with_pool(Matrix *m1, Matrix *m2);
+Matrix* subtract_matrices_with_pool(Matrix *m1, Matrix *m2);
+Matrix* multiply_matrices_with_pool(Matrix *m1, Matrix *m2);
+double determinant_with_pool(Matrix *m);
+// Dominant eigenpair only, by power iteration; eigenvector holds m->rows values
+void compute_eigen_with_pool(Matrix *m, double *eigenvalue, double *eigenvector);
 
 // ===== ✅ ADDED: Matrix Operations - OpenMP (Threading) =====
 Matrix* add_matrices_openmp(Matrix *m1, Matrix *m2);
 Matrix* subtract_matrices_openmp(Matrix *m1, Matrix *m2);
 Matrix* multiply_matrices_openmp(Matrix *m1, Matrix *m2);
+Matrix* multiply_matrices_strassen(Matrix *m1, Matrix *m2);
 double determinant_openmp(Matrix *m);
 
 // ===== Single-threaded Versions (Baseline) =====